@@ -0,0 +1,104 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// Global operator new/delete replacement that counts heap allocations, for use in benchmarks. Include this header in
+//  exactly one translation unit of a benchmark executable.
+
+namespace bench {
+
+inline std::atomic<std::size_t> allocation_count{0};
+
+// Not inlined into the operator delete replacements, as GCC would otherwise flag every `delete` as a mismatched free.
+[[gnu::noinline]] inline void deallocate(void* pointer) noexcept {
+  std::free(pointer);
+}
+
+// Report the number of heap allocations per benchmark iteration since construction as the "allocs" user counter.
+class allocation_scope final {
+  benchmark::State& state_;
+  std::size_t       start_;
+
+public:
+  explicit allocation_scope(benchmark::State& state)
+    : state_{state}
+    , start_{allocation_count.load(std::memory_order_relaxed)} {
+  }
+
+  allocation_scope(const allocation_scope&)            = delete;
+  allocation_scope& operator=(const allocation_scope&) = delete;
+
+  ~allocation_scope() {
+    const auto count = allocation_count.load(std::memory_order_relaxed) - start_;
+    state_.counters["allocs"] = benchmark::Counter(static_cast<double>(count), benchmark::Counter::kAvgIterations);
+  }
+};
+
+} // namespace bench
+
+void* operator new(std::size_t size) {
+  bench::allocation_count.fetch_add(1, std::memory_order_relaxed);
+
+  if (void* pointer = std::malloc((size == 0) ? 1 : size)) {
+    return pointer;
+  }
+
+  throw std::bad_alloc{};
+}
+
+void* operator new[](std::size_t size) {
+  return ::operator new(size);
+}
+
+void operator delete(void* pointer) noexcept {
+  bench::deallocate(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+  bench::deallocate(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+  bench::deallocate(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept {
+  bench::deallocate(pointer);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+  bench::allocation_count.fetch_add(1, std::memory_order_relaxed);
+
+  const auto align = static_cast<std::size_t>(alignment);
+
+  if (void* pointer = std::aligned_alloc(align, ((size + align - 1) / align) * align)) {
+    return pointer;
+  }
+
+  throw std::bad_alloc{};
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+  return ::operator new(size, alignment);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept {
+  bench::deallocate(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t) noexcept {
+  bench::deallocate(pointer);
+}
+
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept {
+  bench::deallocate(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept {
+  bench::deallocate(pointer);
+}
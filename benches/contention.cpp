@@ -0,0 +1,260 @@
+#include "../source/histogram.hpp"
+#include "../source/multiqueue.hpp"
+#include "../source/safe_queue.hpp"
+#include "../source/simple_scheduler.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <thread>
+#include <vector>
+
+// Multi-threaded contention benchmarks for the queues and the scheduler.
+//
+// All benchmarks report throughput (items_per_second) and, where applicable, latency percentiles as user counters.
+//  Use `--benchmark_format=json` (or `--benchmark_out=<file> --benchmark_out_format=json`) for machine-readable
+//  output to compare queue and scheduler variants.
+
+using namespace ts;
+
+namespace {
+
+constexpr std::size_t QUEUE_LENGTH    = 1'024;
+constexpr std::size_t ITEMS_PER_BATCH = 100'000;
+
+const auto NUM_CORES = static_cast<int64_t>(std::max(std::thread::hardware_concurrency(), 1u));
+
+void spin_for(std::chrono::nanoseconds duration) {
+  const auto end = std::chrono::steady_clock::now() + duration;
+
+  while (std::chrono::steady_clock::now() < end) {
+  }
+}
+
+void report_latencies(benchmark::State& state, const latency_histogram& histogram) {
+  const auto to_counter = [](std::chrono::nanoseconds value) { return static_cast<double>(value.count()); };
+
+  state.counters["p50_ns"]  = to_counter(histogram.percentile(50));
+  state.counters["p99_ns"]  = to_counter(histogram.percentile(99));
+  state.counters["p999_ns"] = to_counter(histogram.percentile(99.9));
+  state.counters["max_ns"]  = to_counter(histogram.max());
+}
+
+// Move a batch of items through a single queue with a configurable number of producer and consumer threads.
+template<typename Queue>
+void BM_QueueProducersConsumers(benchmark::State& state) {
+  const auto num_producers = static_cast<std::size_t>(state.range(0));
+  const auto num_consumers = static_cast<std::size_t>(state.range(1));
+
+  for (auto _ : state) {
+    Queue                    queue;
+    std::atomic<std::size_t> consumed = 0;
+
+    {
+      std::vector<std::jthread> threads;
+
+      for (std::size_t p = 0; p < num_producers; p++) {
+        threads.emplace_back([&, p] {
+          for (std::size_t i = p; i < ITEMS_PER_BATCH; i += num_producers) {
+            while (!queue.push(i)) {
+              std::this_thread::yield();
+            }
+          }
+        });
+      }
+
+      for (std::size_t c = 0; c < num_consumers; c++) {
+        threads.emplace_back([&] {
+          while (consumed.load(std::memory_order_relaxed) < ITEMS_PER_BATCH) {
+            if (queue.pop()) {
+              consumed.fetch_add(1, std::memory_order_relaxed);
+            } else {
+              std::this_thread::yield();
+            }
+          }
+        });
+      }
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(ITEMS_PER_BATCH));
+}
+
+// Move a batch of items through a multiqueue, with every consumer popping from its own queue (stealing when empty).
+template<typename Queue>
+void BM_MultiqueueProducersConsumers(benchmark::State& state) {
+  const auto num_producers = static_cast<std::size_t>(state.range(0));
+  const auto num_consumers = static_cast<std::size_t>(state.range(1));
+
+  for (auto _ : state) {
+    Queue                    queue{num_consumers};
+    std::atomic<std::size_t> consumed = 0;
+
+    {
+      std::vector<std::jthread> threads;
+
+      for (std::size_t p = 0; p < num_producers; p++) {
+        threads.emplace_back([&, p] {
+          for (std::size_t i = p; i < ITEMS_PER_BATCH; i += num_producers) {
+            while (!queue.push(i)) {
+              std::this_thread::yield();
+            }
+          }
+        });
+      }
+
+      for (std::size_t c = 0; c < num_consumers; c++) {
+        threads.emplace_back([&, c] {
+          while (consumed.load(std::memory_order_relaxed) < ITEMS_PER_BATCH) {
+            if (queue.pop(c)) {
+              consumed.fetch_add(1, std::memory_order_relaxed);
+            } else {
+              std::this_thread::yield();
+            }
+          }
+        });
+      }
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(ITEMS_PER_BATCH));
+}
+
+// End-to-end scheduler throughput: submit tasks of a given granularity from a number of producer threads and wait
+//  for all of them to complete. The skew argument sets the percentage of tasks submitted by the first producer (the
+//  remainder is spread evenly over the other producers). Reports schedule-to-completion latency percentiles.
+void BM_SchedulerCompletion(benchmark::State& state) {
+  const auto num_executors = static_cast<std::size_t>(state.range(0));
+  const auto num_producers = static_cast<std::size_t>(state.range(1));
+  const auto granularity   = std::chrono::nanoseconds{state.range(2)};
+  const auto skew          = static_cast<std::size_t>(state.range(3));
+  const auto num_tasks     = static_cast<std::size_t>(state.range(4));
+
+  simple_scheduler<QUEUE_LENGTH> s{num_executors};
+
+  const auto tasks_for_producer = [&](std::size_t producer) {
+    if (num_producers == 1) {
+      return num_tasks;
+    }
+
+    const auto hot_tasks  = (num_tasks * skew) / 100;
+    const auto cold_tasks = (num_tasks - hot_tasks) / (num_producers - 1);
+
+    if (producer == 0) {
+      return hot_tasks;
+    }
+
+    // The last producer takes the rounding remainder, so that all tasks are submitted.
+    if (producer == (num_producers - 1)) {
+      return num_tasks - hot_tasks - (cold_tasks * (num_producers - 2));
+    }
+
+    return cold_tasks;
+  };
+
+  latency_histogram        latencies;
+  std::atomic<std::size_t> rejections = 0;
+  std::size_t              completed  = 0;
+
+  for (auto _ : state) {
+    std::vector<latency_histogram> producer_latencies(num_producers);
+
+    {
+      std::vector<std::jthread> producers;
+
+      for (std::size_t p = 0; p < num_producers; p++) {
+        producers.emplace_back([&, p] {
+          const auto count = tasks_for_producer(p);
+
+          std::vector<std::chrono::steady_clock::time_point> start_times(count);
+          std::vector<std::chrono::steady_clock::time_point> end_times(count);
+          std::vector<completion_token>                      completions;
+          completions.reserve(count);
+
+          for (std::size_t i = 0; i < count; i++) {
+            task<void()> t{[&, i] {
+              spin_for(granularity);
+              end_times[i] = std::chrono::steady_clock::now();
+            }};
+
+            start_times[i] = std::chrono::steady_clock::now();
+
+            std::optional<completion_token> completion;
+            while (!(completion = s.schedule(std::move(t)))) {
+              rejections.fetch_add(1, std::memory_order_relaxed);
+              std::this_thread::yield();
+            }
+
+            completions.push_back(*completion);
+          }
+
+          for (std::size_t i = 0; i < count; i++) {
+            completions[i].wait();
+            producer_latencies[p].record(end_times[i] - start_times[i]);
+          }
+        });
+      }
+    }
+
+    for (const auto& producer_latency : producer_latencies) {
+      completed += producer_latency.count();
+      latencies += producer_latency;
+    }
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(completed));
+  state.counters["rejections"] = static_cast<double>(rejections.load());
+  report_latencies(state, latencies);
+}
+
+void scheduler_arguments(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"executors", "producers", "granularity_ns", "skew_pct", "tasks"});
+
+  // Powers of two up to the number of cores, always ending at the number of cores itself.
+  std::vector<int64_t> executor_counts;
+
+  for (int64_t executors = 1; executors < NUM_CORES; executors *= 2) {
+    executor_counts.push_back(executors);
+  }
+
+  executor_counts.push_back(NUM_CORES);
+
+  for (const auto executors : executor_counts) {
+    for (int64_t producers : {1, 4}) {
+      for (int64_t granularity : {0, 100, 10'000, 1'000'000}) {
+        const int64_t tasks = (granularity >= 1'000'000) ? 64 : 4'096;
+
+        benchmark->Args({executors, producers, granularity, 100 / producers, tasks});
+
+        if (producers > 1) {
+          benchmark->Args({executors, producers, granularity, 90, tasks}); // Skewed submission.
+        }
+      }
+    }
+  }
+}
+
+void queue_arguments(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"producers", "consumers"});
+
+  for (int64_t producers : {1, 2, 4, 8}) {
+    for (int64_t consumers : {1, 2, 4, 8}) {
+      benchmark->Args({producers, consumers});
+    }
+  }
+}
+
+} // namespace
+
+BENCHMARK(BM_QueueProducersConsumers<safe_queue<std::size_t, QUEUE_LENGTH>>)->Apply(queue_arguments)->UseRealTime();
+BENCHMARK(BM_MultiqueueProducersConsumers<multiqueue<std::size_t, QUEUE_LENGTH>>)
+  ->Apply(queue_arguments)
+  ->UseRealTime();
+BENCHMARK(BM_SchedulerCompletion)->Apply(scheduler_arguments)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,147 @@
+#include "../source/simple_scheduler.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <thread>
+#include <vector>
+
+// Deadline-miss ratio of earliest-deadline-first (EDF) scheduling versus FIFO scheduling.
+//
+// Every iteration schedules a batch of tasks with a fixed execution time, in random order with respect to their
+//  deadlines. The executors are held until the whole batch is submitted, and the deadlines are relative to the release
+//  of the executors. They are spread such that the batch is feasible when run in deadline order (with some slack), so
+//  all misses are caused by the processing order. A task misses its deadline if it starts after it. The miss ratio is
+//  reported as the `miss_ratio` user counter.
+
+using namespace ts;
+
+namespace {
+
+constexpr std::size_t QUEUE_LENGTH = 1'024;
+
+const auto NUM_CORES = static_cast<int64_t>(std::max(std::thread::hardware_concurrency(), 1u));
+
+enum class ordering { fifo, edf };
+
+void spin_for(std::chrono::nanoseconds duration) {
+  const auto end = std::chrono::steady_clock::now() + duration;
+
+  while (std::chrono::steady_clock::now() < end) {
+  }
+}
+
+template<ordering Ordering>
+void BM_DeadlineMissRatio(benchmark::State& state) {
+  const auto num_executors = static_cast<std::size_t>(state.range(0));
+  const auto num_tasks     = static_cast<std::size_t>(state.range(1));
+  const auto granularity   = std::chrono::nanoseconds{state.range(2)};
+  const auto slack_pct     = state.range(3);
+
+  simple_scheduler<QUEUE_LENGTH> s{num_executors};
+  std::mt19937                   generator{42};
+  std::vector<std::size_t>       ranks(num_tasks);
+  std::atomic<std::size_t>       misses = 0;
+  std::size_t                    total  = 0;
+
+  std::iota(ranks.begin(), ranks.end(), std::size_t{});
+
+  for (auto _ : state) {
+    std::shuffle(ranks.begin(), ranks.end(), generator);
+
+    std::vector<completion_token> completions;
+    completions.reserve(num_tasks + num_executors);
+
+    // Hold all executors, so the batch is queued completely before processing starts.
+    std::atomic<std::size_t>              held     = 0;
+    std::atomic<bool>                     released = false;
+    std::chrono::steady_clock::time_point release;
+
+    for (std::size_t i = 0; i < num_executors; i++) {
+      completions.push_back(*s.schedule([&] {
+        held++;
+        released.wait(false);
+      }));
+    }
+
+    while (held < num_executors) {
+      std::this_thread::yield();
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for (const auto rank : ranks) {
+      const auto slot   = static_cast<int64_t>(rank / num_executors + 1);
+      const auto offset = granularity * slot * (100 + slack_pct) / 100;
+
+      task<void()> t{[&, offset] {
+        if (std::chrono::steady_clock::now() > (release + offset)) {
+          misses.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        spin_for(granularity);
+      }};
+
+      std::optional<completion_token> completion;
+
+      if constexpr (Ordering == ordering::edf) {
+        completion = s.schedule(std::move(t), start + offset);
+      } else {
+        completion = s.schedule(std::move(t));
+      }
+
+      if (!completion) {
+        state.SkipWithError("Scheduling failed, increase the queue length");
+        return;
+      }
+
+      completions.push_back(*completion);
+    }
+
+    release  = std::chrono::steady_clock::now();
+    released = true;
+    released.notify_all();
+
+    for (const auto& completion : completions) {
+      completion.wait();
+    }
+
+    total += num_tasks;
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(total));
+  state.counters["miss_ratio"] =
+    static_cast<double>(misses.load()) / static_cast<double>(std::max<std::size_t>(total, 1));
+}
+
+void deadline_arguments(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"executors", "tasks", "granularity_ns", "slack_pct"});
+
+  for (int64_t executors = 1; executors <= NUM_CORES; executors *= 2) {
+    for (int64_t granularity : {10'000, 100'000}) {
+      for (int64_t slack : {10, 50}) {
+        benchmark->Args({executors, 256, granularity, slack});
+      }
+    }
+  }
+}
+
+} // namespace
+
+BENCHMARK(BM_DeadlineMissRatio<ordering::fifo>)
+  ->Apply(deadline_arguments)
+  ->UseRealTime()
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_DeadlineMissRatio<ordering::edf>)
+  ->Apply(deadline_arguments)
+  ->UseRealTime()
+  ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
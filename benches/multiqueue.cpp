@@ -0,0 +1,137 @@
+#include "../source/multiqueue.hpp"
+
+#include "allocation_counter.hpp"
+#include "perf_counters.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+using namespace ts;
+
+static constexpr std::size_t QUEUE_LENGTH = 1'024;
+
+using test_queue = multiqueue<int, QUEUE_LENGTH>;
+
+static void queue_counts(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgName("queues")->RangeMultiplier(4)->Range(1, static_cast<int64_t>(test_queue::max_num_queues()));
+}
+
+static void BM_Construction(benchmark::State& state) {
+  const auto num_queues = static_cast<std::size_t>(state.range(0));
+
+  bench::allocation_scope allocations{state};
+
+  for (auto _ : state) {
+    test_queue x{num_queues};
+    benchmark::DoNotOptimize(x);
+  }
+}
+
+// Round-robin push over all queues, and pop from the pushed-to queue (no stealing).
+static void BM_PushPop(benchmark::State& state) {
+  const auto num_queues = static_cast<std::size_t>(state.range(0));
+
+  test_queue x{num_queues};
+
+  bench::perf_counters counters;
+  bench::perf_scope    perf{state, counters, 2 * num_queues};
+
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < num_queues; i++) {
+      [[maybe_unused]] auto result = x.push(42);
+    }
+
+    for (std::size_t i = 0; i < num_queues; i++) {
+      benchmark::DoNotOptimize(x.pop(i));
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(num_queues));
+}
+
+// Fill the multiqueue through the round-robin push, and report how evenly the elements are distributed over the
+//  queues (the coefficient of variation of the queue sizes; zero for a perfectly uniform distribution).
+static void BM_PushDistribution(benchmark::State& state) {
+  const auto num_queues   = static_cast<std::size_t>(state.range(0));
+  const auto num_elements = (num_queues * QUEUE_LENGTH) / 2;
+
+  double variation = 0.0;
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    test_queue x{num_queues};
+    state.ResumeTiming();
+
+    for (std::size_t i = 0; i < num_elements; i++) {
+      [[maybe_unused]] auto result = x.push(42);
+    }
+
+    state.PauseTiming();
+
+    const auto mean = static_cast<double>(num_elements) / static_cast<double>(num_queues);
+
+    double sum_of_squares = 0.0;
+    for (std::size_t i = 0; i < num_queues; i++) {
+      const auto deviation = static_cast<double>(x.queue_size(i)) - mean;
+      sum_of_squares += deviation * deviation;
+    }
+
+    variation = std::sqrt(sum_of_squares / static_cast<double>(num_queues)) / mean;
+
+    state.ResumeTiming();
+  }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(num_elements));
+  state.counters["variation"] = variation;
+}
+
+// Steal path cost: only the last queue in stealing order from the popping queue holds work. The occupancy bitmap
+//  finds it with a word scan instead of visiting every other queue, so the cost grows with the number of bitmap words
+//  rather than the number of queues.
+static void BM_StealFromLastQueue(benchmark::State& state) {
+  const auto num_queues = static_cast<std::size_t>(state.range(0));
+  const auto victim     = num_queues - 1;
+
+  test_queue x{num_queues};
+
+  [[maybe_unused]] auto pushed = x.push(victim, 42);
+
+  bench::perf_counters counters;
+  bench::perf_scope    perf{state, counters};
+
+  for (auto _ : state) {
+    auto element = x.pop(0);
+    benchmark::DoNotOptimize(element);
+
+    [[maybe_unused]] auto result = x.push(victim, *element);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Idle executor cost: all queues are empty, so every pop scans the empty occupancy bitmap without finding an element.
+static void BM_PopEmpty(benchmark::State& state) {
+  const auto num_queues = static_cast<std::size_t>(state.range(0));
+
+  test_queue x{num_queues};
+
+  bench::perf_counters counters;
+  bench::perf_scope    perf{state, counters};
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(x.pop(0));
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_Construction)->Apply(queue_counts);
+BENCHMARK(BM_PushPop)->Apply(queue_counts);
+BENCHMARK(BM_PushDistribution)->Apply(queue_counts);
+BENCHMARK(BM_StealFromLastQueue)->Apply(queue_counts);
+BENCHMARK(BM_PopEmpty)->Apply(queue_counts);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Hardware performance counters for benchmarks, using Linux perf_event_open.
+//
+// The counters are opened for the calling thread and inherited by all threads it creates afterwards, so open them
+//  before constructing a scheduler to include its executors. Counters that are not supported or not permitted (see
+//  /proc/sys/kernel/perf_event_paranoid) are left out of the results; when none are available, the benchmark is only
+//  labeled as such.
+
+namespace bench {
+
+#ifdef __linux__
+constexpr std::uint64_t perf_cache_read_misses(std::uint64_t cache) {
+  return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+#endif
+
+class perf_counters final {
+public:
+  struct event {
+    const char*   name;
+    std::uint32_t type;
+    std::uint64_t config;
+  };
+
+#ifdef __linux__
+  static constexpr std::array<event, 6> EVENTS{{
+    {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {"L1D_misses", PERF_TYPE_HW_CACHE, perf_cache_read_misses(PERF_COUNT_HW_CACHE_L1D)},
+    {"LLC_misses", PERF_TYPE_HW_CACHE, perf_cache_read_misses(PERF_COUNT_HW_CACHE_LL)},
+    {"branch_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {"ctx_switches", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES},
+  }};
+#else
+  static constexpr std::array<event, 0> EVENTS{};
+#endif
+
+private:
+  std::array<int, EVENTS.size()> descriptors_;
+
+public:
+  perf_counters() {
+    descriptors_.fill(-1);
+
+#ifdef __linux__
+    for (std::size_t i = 0; i < EVENTS.size(); i++) {
+      perf_event_attr attributes{};
+      attributes.size           = sizeof(attributes);
+      attributes.type           = EVENTS[i].type;
+      attributes.config         = EVENTS[i].config;
+      attributes.disabled       = 1;
+      attributes.inherit        = 1;
+      attributes.exclude_kernel = 1;
+      attributes.exclude_hv     = 1;
+      attributes.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+      descriptors_[i] = static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+    }
+#endif
+  }
+
+  perf_counters(const perf_counters&)            = delete;
+  perf_counters& operator=(const perf_counters&) = delete;
+
+  ~perf_counters() {
+#ifdef __linux__
+    for (const auto descriptor : descriptors_) {
+      if (descriptor >= 0) {
+        close(descriptor);
+      }
+    }
+#endif
+  }
+
+  [[nodiscard]] bool available() const noexcept {
+    for (const auto descriptor : descriptors_) {
+      if (descriptor >= 0) {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  void start() noexcept {
+#ifdef __linux__
+    for (const auto descriptor : descriptors_) {
+      if (descriptor >= 0) {
+        ioctl(descriptor, PERF_EVENT_IOC_RESET, 0);
+        ioctl(descriptor, PERF_EVENT_IOC_ENABLE, 0);
+      }
+    }
+#endif
+  }
+
+  void stop() noexcept {
+#ifdef __linux__
+    for (const auto descriptor : descriptors_) {
+      if (descriptor >= 0) {
+        ioctl(descriptor, PERF_EVENT_IOC_DISABLE, 0);
+      }
+    }
+#endif
+  }
+
+  // Read a counter value, scaled for multiplexing. Empty if the counter is not available.
+  [[nodiscard]] std::optional<double> read(std::size_t index) const noexcept {
+#ifdef __linux__
+    struct {
+      std::uint64_t value;
+      std::uint64_t time_enabled;
+      std::uint64_t time_running;
+    } result{};
+
+    if ((descriptors_[index] < 0) || (::read(descriptors_[index], &result, sizeof(result)) != sizeof(result))) {
+      return {};
+    }
+
+    if (result.time_running == 0) {
+      return 0.0;
+    }
+
+    return static_cast<double>(result.value) * static_cast<double>(result.time_enabled)
+           / static_cast<double>(result.time_running);
+#else
+    (void)index;
+    return {};
+#endif
+  }
+};
+
+// Measure the counters over the lifetime of the scope, and report them per operation as user counters. Construct the
+//  scope before the benchmark loop; the number of operations per benchmark iteration sets the unit (e.g. per task or
+//  per queue operation).
+class perf_scope final {
+  benchmark::State& state_;
+  perf_counters&    counters_;
+  std::size_t       operations_per_iteration_;
+
+public:
+  perf_scope(benchmark::State& state, perf_counters& counters, std::size_t operations_per_iteration = 1)
+    : state_{state}
+    , counters_{counters}
+    , operations_per_iteration_{operations_per_iteration} {
+    counters_.start();
+  }
+
+  perf_scope(const perf_scope&)            = delete;
+  perf_scope& operator=(const perf_scope&) = delete;
+
+  ~perf_scope() {
+    counters_.stop();
+
+    if (!counters_.available()) {
+      state_.SetLabel("perf counters unavailable");
+      return;
+    }
+
+    const auto operations = static_cast<double>(state_.iterations()) * static_cast<double>(operations_per_iteration_);
+
+    if (operations == 0.0) {
+      return;
+    }
+
+    std::array<std::optional<double>, perf_counters::EVENTS.size()> values;
+
+    for (std::size_t i = 0; i < values.size(); i++) {
+      if ((values[i] = counters_.read(i))) {
+        state_.counters[perf_counters::EVENTS[i].name] = *values[i] / operations;
+      }
+    }
+
+    if constexpr (perf_counters::EVENTS.size() >= 2) {
+      if (values[0] && values[1] && (*values[0] > 0.0)) {
+        state_.counters["IPC"] = *values[1] / *values[0];
+      }
+    }
+  }
+};
+
+} // namespace bench
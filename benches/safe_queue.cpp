@@ -1,9 +1,60 @@
 #include "../source/safe_queue.hpp"
+#include "../source/mpsc_queue.hpp"
+
+#include "perf_counters.hpp"
 
 #include <benchmark/benchmark.h>
 
+#include <array>
 #include <cstddef>
 #include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <thread>
+#include <utility>
+
+// Queue with the layout of the original safe_queue (no cache line alignment, locked size checks), used as a false
+//  sharing reference for the contention benchmarks.
+template<typename T, std::size_t MaxSize>
+class packed_queue final {
+  std::deque<T>             queue_;
+  mutable std::shared_mutex mutex_;
+
+public:
+  [[nodiscard]] bool empty() const {
+    std::shared_lock lock{mutex_};
+    return queue_.empty();
+  }
+
+  template<typename U>
+  [[nodiscard]] bool push(U&& element) {
+    std::unique_lock lock{mutex_};
+
+    if (queue_.size() >= MaxSize) {
+      return false;
+    }
+
+    queue_.push_back(std::forward<U>(element));
+
+    return true;
+  }
+
+  [[nodiscard]] std::optional<T> pop() {
+    std::unique_lock lock{mutex_};
+    std::optional<T> result;
+
+    if (queue_.empty()) {
+      return result;
+    }
+
+    result = std::move(queue_.front());
+    queue_.pop_front();
+
+    return result;
+  }
+};
 
 template<typename Queue>
 void BM_Construction(benchmark::State& state) {
@@ -16,13 +67,16 @@ template<typename Queue>
 void BM_PushData(benchmark::State& state) {
   Queue x;
 
+  bench::perf_counters counters;
+  bench::perf_scope    perf{state, counters, x.max_size()};
+
   for (auto _ : state) {
     for (std::size_t i = 0; i < x.max_size(); i++) {
       [[maybe_unused]] auto result = x.push(42);
     }
   }
 
-  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(x.max_size()));
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(x.max_size()));
 }
 
 template<typename Queue>
@@ -43,7 +97,38 @@ void BM_PopData(benchmark::State& state) {
     }
   }
 
-  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(x.max_size()));
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(x.max_size()));
+}
+
+// Every thread works on its own queue, with the queues laid out back to back. Any slowdown with increasing thread
+//  count is caused by false sharing between neighbouring queues.
+template<typename Queue>
+void BM_NeighbourContention(benchmark::State& state) {
+  static constexpr std::size_t MAX_THREADS = 64;
+  static std::array<Queue, MAX_THREADS> queues;
+
+  auto& queue = queues[static_cast<std::size_t>(state.thread_index()) % MAX_THREADS];
+
+  for (auto _ : state) {
+    [[maybe_unused]] auto pushed = queue.push(42);
+    benchmark::DoNotOptimize(queue.empty());
+    benchmark::DoNotOptimize(queue.pop());
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+// All threads push to and pop from a single queue, as producers scheduling onto the queue of a single executor.
+template<typename Queue>
+void BM_SharedQueue(benchmark::State& state) {
+  static Queue queue;
+
+  for (auto _ : state) {
+    [[maybe_unused]] auto pushed = queue.push(42);
+    benchmark::DoNotOptimize(queue.pop());
+  }
+
+  state.SetItemsProcessed(state.iterations());
 }
 
 using namespace ts;
@@ -59,11 +144,19 @@ BENCHMARK(BM_PushData<safe_queue<int, 10>>);
 BENCHMARK(BM_PushData<safe_queue<int, 100>>);
 BENCHMARK(BM_PushData<safe_queue<int, 1'024>>);
 BENCHMARK(BM_PushData<safe_queue<int, safe_queue_max_size_limit>>);
+BENCHMARK(BM_PushData<mpsc_queue<int, 1'024>>);
 
 BENCHMARK(BM_PopData<safe_queue<int, 1>>);
 BENCHMARK(BM_PopData<safe_queue<int, 10>>);
 BENCHMARK(BM_PopData<safe_queue<int, 100>>);
 BENCHMARK(BM_PopData<safe_queue<int, 1'024>>);
 BENCHMARK(BM_PopData<safe_queue<int, safe_queue_max_size_limit>>);
+BENCHMARK(BM_PopData<mpsc_queue<int, 1'024>>);
+
+BENCHMARK(BM_NeighbourContention<packed_queue<int, 16>>)->ThreadRange(1, static_cast<int>(std::thread::hardware_concurrency()));
+BENCHMARK(BM_NeighbourContention<safe_queue<int, 16>>)->ThreadRange(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+BENCHMARK(BM_SharedQueue<safe_queue<int, 1'024>>)->ThreadRange(1, static_cast<int>(std::thread::hardware_concurrency()));
+BENCHMARK(BM_SharedQueue<mpsc_queue<int, 1'024>>)->ThreadRange(1, static_cast<int>(std::thread::hardware_concurrency()));
 
 BENCHMARK_MAIN();
@@ -1,9 +1,18 @@
 #include "../source/simple_scheduler.hpp"
 
+#include "../source/this_executor.hpp"
+#include "perf_counters.hpp"
+
 #include <benchmark/benchmark.h>
 
+#include <array>
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory_resource>
 #include <thread>
+#include <vector>
 
 using namespace ts;
 
@@ -22,16 +31,171 @@ static void BM_Construction(benchmark::State& state) {
 static void BM_ScheduleWork(benchmark::State& state) {
   const auto num_executors = static_cast<std::size_t>(state.range(0));
 
-  test_scheduler s{num_executors};
+  // Opened before the scheduler is constructed, so the executor threads are included in the counts.
+  bench::perf_counters counters;
+
+  test_scheduler    s{num_executors};
+  bench::perf_scope perf{state, counters, QUEUE_LENGTH};
 
   for (auto _ : state) {
     for (unsigned int i = 0; i < QUEUE_LENGTH; i++) {
       benchmark::DoNotOptimize(s.schedule([]{}));
     }
+
+    s.wait_idle();
   }
 }
 
+static void BM_ScheduleDetachedWork(benchmark::State& state) {
+  const auto num_executors = static_cast<std::size_t>(state.range(0));
+
+  // Opened before the scheduler is constructed, so the executor threads are included in the counts.
+  bench::perf_counters counters;
+
+  test_scheduler    s{num_executors};
+  bench::perf_scope perf{state, counters, QUEUE_LENGTH};
+
+  for (auto _ : state) {
+    for (unsigned int i = 0; i < QUEUE_LENGTH; i++) {
+      s.schedule_detached([]{});
+    }
+
+    s.wait_idle();
+  }
+}
+
+// A chain of tasks passing a message: every task consumes the message written by its predecessor, writes the next
+//  message and schedules its successor (actor-style message passing). With the LIFO slot, the successor runs next on
+//  the same executor, while the message is still in the cache.
+struct ping_pong_chain {
+  static constexpr std::size_t MESSAGE_WORDS = 512; // 4 KiB.
+
+  std::array<std::uint64_t, MESSAGE_WORDS> message{};
+  std::size_t                              hops_left{};
+  std::atomic<bool>                        done{};
+};
+
+static void ping_pong(test_scheduler& s, ping_pong_chain& chain) {
+  for (auto& word : chain.message) {
+    word = word * 31 + 1;
+  }
+
+  if (--chain.hops_left == 0) {
+    chain.done = true;
+    chain.done.notify_one();
+    return;
+  }
+
+  (void)s.schedule([&s, &chain] { ping_pong(s, chain); });
+}
+
+// Tasks using a temporary buffer, allocated from the heap or from the executor arena.
+static void BM_TemporaryAllocation(benchmark::State& state) {
+  const auto num_executors = static_cast<std::size_t>(state.range(0));
+  const auto use_arena     = (state.range(1) != 0);
+
+  test_scheduler s{num_executors};
+
+  const auto fill = [](auto& buffer) {
+    for (int i = 0; i < 256; i++) {
+      buffer.push_back(i);
+    }
+
+    benchmark::DoNotOptimize(buffer.data());
+  };
+
+  for (auto _ : state) {
+    for (unsigned int i = 0; i < QUEUE_LENGTH; i++) {
+      if (use_arena) {
+        s.schedule_detached([&] {
+          std::pmr::vector<int> buffer{&this_executor::context().arena()};
+          fill(buffer);
+        });
+      } else {
+        s.schedule_detached([&] {
+          std::vector<int> buffer;
+          fill(buffer);
+        });
+      }
+    }
+
+    s.wait_idle();
+  }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(QUEUE_LENGTH));
+}
+
+// Indexed bulk work: one bulk launch versus scheduling every index as an individual task.
+static void BM_ScheduleN(benchmark::State& state) {
+  const auto num_executors = static_cast<std::size_t>(state.range(0));
+  const auto bulk          = (state.range(1) != 0);
+  const auto count         = static_cast<std::size_t>(state.range(2));
+
+  test_scheduler           s{num_executors};
+  std::atomic<std::size_t> sum = 0;
+
+  for (auto _ : state) {
+    if (bulk) {
+      s.schedule_n(count, [&](std::size_t index) { sum.fetch_add(index, std::memory_order_relaxed); })->wait();
+    } else {
+      for (std::size_t i = 0; i < count; i++) {
+        s.schedule_detached([&, i] { sum.fetch_add(i, std::memory_order_relaxed); });
+      }
+
+      s.wait_idle();
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+}
+
+static void BM_PingPong(benchmark::State& state) {
+  static constexpr std::size_t HOPS = 1'000;
+
+  const auto num_executors = static_cast<std::size_t>(state.range(0));
+  const bool lifo_slot     = (state.range(1) != 0);
+
+  bench::perf_counters counters;
+
+  test_scheduler s{num_executors};
+
+  if (!lifo_slot) {
+    s.disable_lifo_slot();
+  }
+
+  // One chain per executor, so every executor has work.
+  std::deque<ping_pong_chain> chains(num_executors);
+  bench::perf_scope           perf{state, counters, num_executors * HOPS};
+
+  for (auto _ : state) {
+    for (auto& chain : chains) {
+      chain.hops_left = HOPS;
+      chain.done      = false;
+      (void)s.schedule([&s, &chain] { ping_pong(s, chain); });
+    }
+
+    for (auto& chain : chains) {
+      chain.done.wait(false);
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(num_executors * HOPS));
+}
+
 BENCHMARK(BM_Construction)->RangeMultiplier(2)->Range(1, std::thread::hardware_concurrency());
 BENCHMARK(BM_ScheduleWork)->RangeMultiplier(2)->Range(1, std::thread::hardware_concurrency());
+BENCHMARK(BM_ScheduleDetachedWork)->RangeMultiplier(2)->Range(1, std::thread::hardware_concurrency());
+BENCHMARK(BM_TemporaryAllocation)
+  ->ArgNames({"executors", "arena"})
+  ->ArgsProduct({benchmark::CreateRange(1, std::thread::hardware_concurrency(), 2), {0, 1}})
+  ->UseRealTime();
+BENCHMARK(BM_ScheduleN)
+  ->ArgNames({"executors", "bulk", "count"})
+  ->ArgsProduct({benchmark::CreateRange(1, std::thread::hardware_concurrency(), 2), {0, 1}, {1'000, 100'000}})
+  ->UseRealTime();
+BENCHMARK(BM_PingPong)
+  ->ArgNames({"executors", "lifo_slot"})
+  ->ArgsProduct({benchmark::CreateRange(1, std::thread::hardware_concurrency(), 2), {0, 1}})
+  ->UseRealTime();
 
 BENCHMARK_MAIN();
@@ -0,0 +1,109 @@
+#include "../source/task.hpp"
+#include "../source/pool_resource.hpp"
+
+#include "allocation_counter.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+
+using namespace ts;
+
+// Callable with a capture of a given size.
+template<std::size_t CaptureSize>
+struct capture {
+  std::array<std::uint8_t, CaptureSize> data{};
+
+  std::uint8_t operator()() const noexcept {
+    return data[0];
+  }
+};
+
+using small_capture = capture<8>;
+using large_capture = capture<256>;
+
+template<typename Task, typename Callable>
+void BM_Construction(benchmark::State& state) {
+  bench::allocation_scope allocations{state};
+
+  for (auto _ : state) {
+    Task t{Callable{}};
+    benchmark::DoNotOptimize(t);
+  }
+}
+
+// Construction with the task storage allocated from a pool instead of the heap.
+template<typename Callable>
+void BM_PooledConstruction(benchmark::State& state) {
+  pool_resource pool;
+
+  bench::allocation_scope allocations{state};
+
+  for (auto _ : state) {
+    task<std::uint8_t()> t{std::allocator_arg, &pool, Callable{}};
+    benchmark::DoNotOptimize(t);
+  }
+}
+
+template<typename Task, typename Callable>
+void BM_Move(benchmark::State& state) {
+  Task t{Callable{}};
+
+  bench::allocation_scope allocations{state};
+
+  for (auto _ : state) {
+    Task u{std::move(t)};
+    benchmark::DoNotOptimize(u);
+    t = std::move(u);
+  }
+}
+
+template<typename Task, typename Callable>
+void BM_Invoke(benchmark::State& state) {
+  Task t{Callable{}};
+
+  bench::allocation_scope allocations{state};
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(t());
+  }
+}
+
+template<typename Task, typename Callable>
+void BM_ConstructAndInvoke(benchmark::State& state) {
+  bench::allocation_scope allocations{state};
+
+  for (auto _ : state) {
+    Task t{Callable{}};
+    benchmark::DoNotOptimize(t());
+  }
+}
+
+BENCHMARK(BM_Construction<task<std::uint8_t()>, small_capture>);
+BENCHMARK(BM_Construction<task<std::uint8_t()>, large_capture>);
+BENCHMARK(BM_Construction<std::function<std::uint8_t()>, small_capture>);
+BENCHMARK(BM_Construction<std::function<std::uint8_t()>, large_capture>);
+BENCHMARK(BM_PooledConstruction<small_capture>);
+BENCHMARK(BM_PooledConstruction<large_capture>);
+
+BENCHMARK(BM_Move<task<std::uint8_t()>, small_capture>);
+BENCHMARK(BM_Move<task<std::uint8_t()>, large_capture>);
+BENCHMARK(BM_Move<std::function<std::uint8_t()>, small_capture>);
+BENCHMARK(BM_Move<std::function<std::uint8_t()>, large_capture>);
+
+BENCHMARK(BM_Invoke<task<std::uint8_t()>, small_capture>);
+BENCHMARK(BM_Invoke<task<std::uint8_t()>, large_capture>);
+BENCHMARK(BM_Invoke<std::function<std::uint8_t()>, small_capture>);
+BENCHMARK(BM_Invoke<std::function<std::uint8_t()>, large_capture>);
+
+BENCHMARK(BM_ConstructAndInvoke<task<std::uint8_t()>, small_capture>);
+BENCHMARK(BM_ConstructAndInvoke<task<std::uint8_t()>, large_capture>);
+BENCHMARK(BM_ConstructAndInvoke<std::function<std::uint8_t()>, small_capture>);
+BENCHMARK(BM_ConstructAndInvoke<std::function<std::uint8_t()>, large_capture>);
+
+BENCHMARK_MAIN();
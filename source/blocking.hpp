@@ -0,0 +1,60 @@
+#pragma once
+
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+#include "executor_interface.hpp"
+
+namespace ts {
+
+inline namespace v1 {
+
+///
+/// Scope guard marking a blocking region within a task (managed blocking).
+///
+/// When a task blocks (e.g. on file I/O or a lock), its executor cannot process other work. Within a blocking region,
+///  the scheduler temporarily starts a compensating thread that processes the work of the blocked executor, which is
+///  retired when the region ends. This keeps all execution cores busy, while the number of running (non-blocked)
+///  threads stays within the number of executors. As starting a thread is not free, blocking regions should only wrap
+///  calls that block for a significant time.
+///
+/// Outside of a task running on an executor, a blocking region has no effect.
+///
+class blocking_region final {
+  detail::executor_interface* executor_;
+
+public:
+  blocking_region()
+    : executor_{detail::current_executor()} {
+    if (executor_ != nullptr) {
+      executor_->begin_blocking();
+    }
+  }
+
+  ~blocking_region() {
+    if (executor_ != nullptr) {
+      executor_->end_blocking();
+    }
+  }
+
+  blocking_region(const blocking_region&)            = delete;
+  blocking_region& operator=(const blocking_region&) = delete;
+};
+
+///
+/// Call a blocking function within a blocking region (see `blocking_region`).
+///
+/// \param function The blocking function to call.
+///
+/// \returns The return value of the function.
+///
+template<typename Function>
+requires(std::is_invocable_v<Function>) decltype(auto) mark_blocking(Function&& function) {
+  blocking_region region;
+  return std::invoke(std::forward<Function>(function));
+}
+
+} // namespace v1
+
+} // namespace ts
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+
+namespace ts {
+
+inline namespace v1 {
+
+///
+/// Assumed cache line size, used to align data that is written by different threads to avoid false sharing.
+///
+/// Note: `std::hardware_destructive_interference_size` is not used here, as its value depends on compiler flags (e.g.
+///  `-mtune`), making it unsuitable for use in the layout of types defined in headers.
+///
+static constexpr std::size_t cache_line_size{64};
+
+} // namespace v1
+
+} // namespace ts
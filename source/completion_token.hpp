@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <exception>
 #include <memory>
@@ -7,6 +9,10 @@
 #include <optional>
 #include <shared_mutex>
 #include <stdexcept>
+#include <stop_token>
+#include <utility>
+
+#include "executor_interface.hpp"
 
 namespace ts {
 
@@ -18,9 +24,21 @@ class completion_data final {
   mutable std::shared_mutex           mutex_;
   mutable std::condition_variable_any condition_;
   bool                                completed_{false};
+  bool                                cancelled_{false};
   std::optional<std::exception_ptr>   exception_;
+  std::atomic<bool>                   stop_requested_{false};
+  std::stop_source                    stop_source_{std::nostopstate};
 
 public:
+  completion_data() = default;
+
+  ///
+  /// Constructor for completion data with an associated stop state, to be observed by the running task.
+  ///
+  explicit completion_data(std::stop_source stop_source)
+    : stop_source_{std::move(stop_source)} {
+  }
+
   [[nodiscard]] bool is_completed() const {
     std::shared_lock lock{mutex_};
     return completed_;
@@ -31,12 +49,48 @@ public:
     condition_.wait(lock, [this] { return this->completed_; });
   }
 
+  template<typename Rep, typename Period>
+  [[nodiscard]] bool wait_for_completion_for(const std::chrono::duration<Rep, Period>& timeout) const {
+    std::shared_lock lock{mutex_};
+    return condition_.wait_for(lock, timeout, [this] { return this->completed_; });
+  }
+
   void trigger_completion() {
     std::unique_lock lock{mutex_};
     completed_ = true;
     condition_.notify_all();
   }
 
+  void trigger_cancellation() {
+    std::unique_lock lock{mutex_};
+    completed_ = true;
+    cancelled_ = true;
+    condition_.notify_all();
+  }
+
+  [[nodiscard]] bool is_cancelled() const {
+    std::shared_lock lock{mutex_};
+    return cancelled_;
+  }
+
+  bool request_stop() noexcept {
+    const auto requested{!stop_requested_.exchange(true, std::memory_order_relaxed)};
+
+    if (requested) {
+      stop_source_.request_stop();
+    }
+
+    return requested;
+  }
+
+  [[nodiscard]] bool stop_requested() const noexcept {
+    return stop_requested_.load(std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] std::stop_token stop_token() const noexcept {
+    return stop_source_.get_token();
+  }
+
   [[nodiscard]] const std::optional<std::exception_ptr>& exception() const {
     std::shared_lock lock{mutex_};
     return exception_;
@@ -54,6 +108,8 @@ public:
 /// Completion token, a token used to check and wait for associated entity completion.
 ///
 class completion_token final {
+  static constexpr std::chrono::microseconds HELP_POLL_INTERVAL{100};
+
   std::shared_ptr<detail::completion_data> data_;
 
 public:
@@ -74,8 +130,23 @@ public:
   ///
   /// Blocking wait for completion of the associated entity.
   ///
+  /// When called from within a task running on a scheduler executor, the executor keeps processing pending jobs
+  ///  until the associated entity completes (caller-helps waiting). This way, nested tasks waiting on their child
+  ///  tasks cannot deadlock the scheduler once all executors are waiting.
+  ///
   void wait() const {
-    data_->wait_for_completion();
+    auto* executor{detail::current_executor()};
+
+    if (executor == nullptr) {
+      data_->wait_for_completion();
+      return;
+    }
+
+    while (!data_->is_completed()) {
+      if (!executor->run_pending_job()) {
+        (void)data_->wait_for_completion_for(HELP_POLL_INTERVAL);
+      }
+    }
   }
 
   ///
@@ -87,6 +158,37 @@ public:
     return data_->is_completed();
   }
 
+  ///
+  /// Request cancellation of the associated entity.
+  ///
+  /// If the associated task has not started yet, it will be skipped: it completes without running, in the cancelled
+  ///  state. If the task is already running, it can observe the request through its stop token (if it accepts one).
+  ///
+  /// \returns `true` if this call made the cancellation request, `false` if cancellation was already requested.
+  ///
+  bool request_stop() const noexcept {
+    return data_->request_stop();
+  }
+
+  ///
+  /// Check if cancellation of the associated entity was requested.
+  ///
+  /// \returns `true` if cancellation was requested, `false` if otherwise.
+  ///
+  [[nodiscard]] bool stop_requested() const noexcept {
+    return data_->stop_requested();
+  }
+
+  ///
+  /// Check if the associated entity was cancelled: it completed without running, because cancellation was requested
+  ///  before it started.
+  ///
+  /// \returns `true` if the associated entity was cancelled, `false` if otherwise.
+  ///
+  [[nodiscard]] bool cancelled() const {
+    return data_->is_cancelled();
+  }
+
   ///
   /// Check if an exception was thrown during completion of the associated entity.
   ///
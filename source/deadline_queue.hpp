@@ -0,0 +1,276 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+#include "cache_line.hpp"
+#include "safe_queue.hpp"
+
+namespace ts {
+
+inline namespace v1 {
+
+///
+/// Thread-safe deadline-ordered queue (earliest deadline first).
+///
+/// This is a calendar queue: elements are hashed into a fixed number of buckets by deadline, where every bucket covers
+///  a time slot of `bucket_width`, wrapping around after `NumBuckets` slots (one 'year'). A cursor walks the slots in
+///  time order, so that both push and pop are close to O(1) when the deadlines are spread over a limited number of
+///  slots. Elements with equal deadlines are popped in FIFO order. If the cursor cannot find an element within one
+///  year, it jumps to the earliest element directly.
+///
+/// Like `safe_queue`, the queue is cache line aligned, and the current size is kept in an atomic on a separate cache
+///  line. The earliest deadline is kept in an atomic as well, so that it can be inspected without taking the lock (e.g.
+///  to select a queue to steal from).
+///
+/// \param T          The queue element value type.
+/// \param MaxSize    The maximum queue size. Must be in range 1..MAX_SIZE_LIMIT.
+/// \param NumBuckets The number of calendar buckets.
+///
+template<typename T, std::size_t MaxSize, std::size_t NumBuckets = 64>
+requires((MaxSize > 0) && (MaxSize <= MAX_SIZE_LIMIT) && (NumBuckets > 0)) class alignas(cache_line_size)
+  deadline_queue final {
+public:
+  using clock      = std::chrono::steady_clock;
+  using time_point = clock::time_point;
+
+  static constexpr clock::duration default_bucket_width{std::chrono::microseconds{500}};
+
+private:
+  struct entry {
+    time_point deadline_;
+    T          element_;
+  };
+
+  using bucket = std::deque<entry>;
+
+  static constexpr clock::rep NO_DEADLINE{std::numeric_limits<clock::rep>::max()};
+
+  alignas(cache_line_size) std::atomic<std::size_t> size_{};
+  alignas(cache_line_size) std::atomic<clock::rep>  earliest_{NO_DEADLINE};
+  alignas(cache_line_size) std::mutex               mutex_;
+  clock::duration                                   bucket_width_;
+  std::array<bucket, NumBuckets>                    buckets_;
+  std::size_t                                       count_{};
+  std::size_t                                       current_slot_{};
+
+  [[nodiscard]] std::size_t slot(time_point deadline) const noexcept {
+    return static_cast<std::size_t>(std::max(deadline.time_since_epoch(), clock::duration::zero()) / bucket_width_);
+  }
+
+  [[nodiscard]] bucket& slot_bucket(std::size_t slot) noexcept {
+    return buckets_[slot % NumBuckets];
+  }
+
+  // Find the bucket holding the earliest element, advancing the cursor. The queue must not be empty.
+  [[nodiscard]] bucket& locate() {
+    for (std::size_t i{}; i < NumBuckets; i++) {
+      if (auto& candidate{slot_bucket(current_slot_)};
+          !candidate.empty() && (slot(candidate.front().deadline_) == current_slot_)) {
+        return candidate;
+      }
+
+      current_slot_++;
+    }
+
+    // Nothing within a year from the cursor: jump to the earliest element directly.
+    auto& earliest{*std::ranges::min_element(buckets_, [](const bucket& lhs, const bucket& rhs) {
+      return !lhs.empty() && (rhs.empty() || (lhs.front().deadline_ < rhs.front().deadline_));
+    })};
+
+    current_slot_ = slot(earliest.front().deadline_);
+
+    return earliest;
+  }
+
+  void update_earliest() {
+    earliest_.store((count_ == 0) ? NO_DEADLINE : locate().front().deadline_.time_since_epoch().count(),
+                    std::memory_order_relaxed);
+  }
+
+public:
+  ///
+  /// Constructor.
+  ///
+  /// \param bucket_width The time slot covered by a single calendar bucket. Ideally, a bucket holds only a few
+  ///                      elements, while most buckets within the spread of the pending deadlines are non-empty.
+  ///
+  /// \throws `std::invalid_argument` if the bucket width is not positive.
+  ///
+  explicit deadline_queue(clock::duration bucket_width = default_bucket_width)
+    : bucket_width_{bucket_width} {
+    if (bucket_width_ <= clock::duration::zero()) {
+      throw std::invalid_argument("Bucket width must be positive");
+    }
+  }
+
+  deadline_queue(deadline_queue& other) noexcept      = delete;
+  deadline_queue& operator=(deadline_queue&) noexcept = delete;
+
+  ///
+  /// Get the maximum queue size.
+  ///
+  /// \returns The maximum queue length.
+  ///
+  [[nodiscard]] static constexpr std::size_t max_size() noexcept {
+    return MaxSize;
+  }
+
+  ///
+  /// Get the number of calendar buckets.
+  ///
+  /// \returns The number of calendar buckets.
+  ///
+  [[nodiscard]] static constexpr std::size_t num_buckets() noexcept {
+    return NumBuckets;
+  }
+
+  ///
+  /// Get the time slot covered by a single calendar bucket.
+  ///
+  /// \returns The bucket width.
+  ///
+  [[nodiscard]] clock::duration bucket_width() const noexcept {
+    return bucket_width_;
+  }
+
+  ///
+  /// Get the current queue size.
+  ///
+  /// \returns The current queue length.
+  ///
+  [[nodiscard]] std::size_t size() const {
+    return size_.load(std::memory_order_relaxed);
+  }
+
+  ///
+  /// Check if the queue is empty.
+  ///
+  /// \returns `true` if the queue is empty, `false` if otherwise.
+  ///
+  [[nodiscard]] bool empty() const {
+    return (size() == 0);
+  }
+
+  ///
+  /// Get the earliest deadline in the queue, without taking the lock.
+  ///
+  /// \returns An optional deadline. The optional is empty if the queue was empty.
+  ///
+  [[nodiscard]] std::optional<time_point> earliest_deadline() const noexcept {
+    const auto earliest{earliest_.load(std::memory_order_relaxed)};
+
+    if (earliest == NO_DEADLINE) {
+      return {};
+    }
+
+    return time_point{clock::duration{earliest}};
+  }
+
+  ///
+  /// Push a new element into the queue, ordered by deadline.
+  ///
+  /// \param deadline The element deadline.
+  /// \param element  The element to push on the queue.
+  ///
+  /// \returns `true` if the element is accepted, `false` if the queue could not accept the element (because maximum
+  ///           occupation capacity is reached).
+  ///
+  template<typename U>
+  [[nodiscard]] bool push(time_point deadline, U&& element) {
+    std::unique_lock lock{mutex_};
+
+    if (count_ >= MaxSize) {
+      return false;
+    }
+
+    const auto element_slot{slot(deadline)};
+    auto&      target{slot_bucket(element_slot)};
+
+    // Insert after elements with an equal deadline, to retain FIFO order for those.
+    target.insert(std::ranges::upper_bound(target, deadline, {}, &entry::deadline_),
+                  entry{deadline, std::forward<U>(element)});
+
+    // Keep the cursor at or before the earliest element.
+    if ((count_ == 0) || (element_slot < current_slot_)) {
+      current_slot_ = element_slot;
+    }
+
+    count_++;
+    size_.store(count_, std::memory_order_relaxed);
+
+    if (deadline.time_since_epoch().count() < earliest_.load(std::memory_order_relaxed)) {
+      earliest_.store(deadline.time_since_epoch().count(), std::memory_order_relaxed);
+    }
+
+    return true;
+  }
+
+  ///
+  /// Pop the element with the earliest deadline off the queue.
+  ///
+  /// \param deadline Set to the deadline of the popped element, if any.
+  ///
+  /// \returns An optional element. The optional is empty if the queue was empty.
+  ///
+  [[nodiscard]] std::optional<T> pop(time_point& deadline) {
+    std::unique_lock lock{mutex_};
+    std::optional<T> result;
+
+    if (count_ == 0) {
+      return result;
+    }
+
+    auto& source{locate()};
+
+    deadline = source.front().deadline_;
+    result   = std::move(source.front().element_);
+    source.pop_front();
+
+    count_--;
+    size_.store(count_, std::memory_order_relaxed);
+    update_earliest();
+
+    return result;
+  }
+
+  ///
+  /// Pop the element with the earliest deadline off the queue.
+  ///
+  /// \returns An optional element. The optional is empty if the queue was empty.
+  ///
+  [[nodiscard]] std::optional<T> pop() {
+    time_point deadline;
+    return pop(deadline);
+  }
+
+  ///
+  /// Flush the queue, removing all elements.
+  ///
+  /// \returns The number of elements removed.
+  ///
+  std::size_t flush() {
+    std::unique_lock lock{mutex_};
+    const auto size{count_};
+
+    std::ranges::for_each(buckets_, [](auto& b) { b.clear(); });
+    count_ = 0;
+    size_.store(0, std::memory_order_relaxed);
+    earliest_.store(NO_DEADLINE, std::memory_order_relaxed);
+
+    return size;
+  }
+};
+
+} // namespace v1
+
+} // namespace ts
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <typeindex>
+#include <unordered_map>
+
+namespace ts {
+
+inline namespace v1 {
+
+///
+/// Context of a scheduler executor, accessible from the tasks it runs (see `this_executor::context`).
+///
+/// Every executor has a monotonic arena for temporary allocations: allocation is a pointer bump, deallocation is a
+///  no-op, and all memory is released at once when the executor finishes a task. Memory allocated from the arena must
+///  therefore not outlive the task. The arena buffer is only allocated on first use.
+///
+/// Objects that should be reused between the tasks of an executor (e.g. scratch buffers) can be kept in the scratch
+///  cache, which holds a single instance per type for the lifetime of the executor.
+///
+class executor_context final {
+  std::size_t                                                id_;
+  std::size_t                                                arena_size_;
+  std::unique_ptr<std::byte[]>                               arena_buffer_;
+  std::optional<std::pmr::monotonic_buffer_resource>         arena_;
+  std::unordered_map<std::type_index, std::shared_ptr<void>> scratch_;
+
+public:
+  static constexpr std::size_t default_arena_size{64 * 1024};
+
+  ///
+  /// Constructor.
+  ///
+  /// \param id         The executor index.
+  /// \param arena_size The size of the initial arena buffer. When exhausted, the arena grows from the heap until it
+  ///                    is reset.
+  ///
+  explicit executor_context(std::size_t id, std::size_t arena_size = default_arena_size)
+    : id_{id}
+    , arena_size_{arena_size} {
+  }
+
+  executor_context(const executor_context&)            = delete;
+  executor_context& operator=(const executor_context&) = delete;
+
+  ///
+  /// Get the executor index.
+  ///
+  /// \returns The index of the executor, in range `0..num_executors`.
+  ///
+  [[nodiscard]] std::size_t id() const noexcept {
+    return id_;
+  }
+
+  ///
+  /// Get the arena for temporary allocations within the running task.
+  ///
+  /// \returns The arena memory resource, e.g. to use with `std::pmr` containers.
+  ///
+  [[nodiscard]] std::pmr::memory_resource& arena() {
+    if (!arena_) {
+      arena_buffer_ = std::make_unique_for_overwrite<std::byte[]>(arena_size_);
+      arena_.emplace(arena_buffer_.get(), arena_size_);
+    }
+
+    return *arena_;
+  }
+
+  ///
+  /// Release all memory allocated from the arena. Called by the executor after every task.
+  ///
+  void reset_arena() noexcept {
+    if (arena_) {
+      arena_->release();
+    }
+  }
+
+  ///
+  /// Get the scratch object of a type, which is created on first use and kept for the lifetime of the executor.
+  ///
+  /// \param T The scratch object type.
+  ///
+  /// \returns A reference to the scratch object.
+  ///
+  template<typename T>
+  requires(std::default_initializable<T>) [[nodiscard]] T& scratch() {
+    auto& object{scratch_[std::type_index{typeid(T)}]};
+
+    if (!object) {
+      object = std::make_shared<T>();
+    }
+
+    return *static_cast<T*>(object.get());
+  }
+};
+
+} // namespace v1
+
+} // namespace ts
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <memory>
+#include <memory_resource>
+
+#include "executor_context.hpp"
+#include "task.hpp"
+
+namespace ts {
+
+inline namespace v1 {
+
+namespace detail {
+
+class completion_data;
+
+///
+/// Interface to the scheduler executor running on the current thread.
+///
+/// This is used to make types that are unaware of the scheduler type (e.g. the completion token) behave in a
+///  scheduler-aware manner when used from within a task.
+///
+class executor_interface {
+public:
+  virtual ~executor_interface() = default;
+
+  ///
+  /// Run a single pending job on the current executor.
+  ///
+  /// \returns `true` if a job was run, `false` if no pending job was available.
+  ///
+  [[nodiscard]] virtual bool run_pending_job() = 0;
+
+  ///
+  /// Spawn a job onto the queue of the current executor.
+  ///
+  /// \param task       A function object to be processed. If spawning failed, the task will be moved back.
+  /// \param completion The completion data to signal when the task is processed.
+  ///
+  /// \returns `true` if the job was accepted, `false` if the scheduler could not accept it. A scheduler that moves
+  ///           work out of a full executor queue (like `simple_scheduler`) always accepts the job.
+  ///
+  [[nodiscard]] virtual bool spawn(task<void()>&& task, std::shared_ptr<completion_data> completion) = 0;
+
+  ///
+  /// Signal that the current executor is about to block (e.g. on I/O or a lock). The executor may be compensated for
+  ///  by another thread processing its work in the meantime, until `end_blocking` is called.
+  ///
+  virtual void begin_blocking() = 0;
+
+  ///
+  /// Signal that the current executor is no longer blocked. Must match an earlier call to `begin_blocking`.
+  ///
+  virtual void end_blocking() = 0;
+
+  ///
+  /// Get the context of the current executor.
+  ///
+  /// \returns A reference to the executor context.
+  ///
+  [[nodiscard]] virtual executor_context& context() noexcept = 0;
+
+  ///
+  /// Get the memory resource of the scheduler, e.g. to allocate the completion data of spawned jobs from.
+  ///
+  /// \returns A pointer to the memory resource.
+  ///
+  [[nodiscard]] virtual std::pmr::memory_resource* resource() const noexcept = 0;
+};
+
+///
+/// Get the executor running on the current thread.
+///
+/// \returns A reference to the executor pointer for the current thread. Will hold `nullptr` if the current thread is
+///           not an executor thread.
+///
+[[nodiscard]] inline executor_interface*& current_executor() noexcept {
+  static thread_local executor_interface* executor{nullptr};
+  return executor;
+}
+
+} // namespace detail
+
+} // namespace v1
+
+} // namespace ts
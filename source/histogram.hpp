@@ -0,0 +1,204 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+namespace ts {
+
+inline namespace v1 {
+
+///
+/// Log-linear (HDR-style) latency histogram.
+///
+/// Values are recorded with nanosecond resolution. Every power-of-two range is split into `SUB_BUCKETS` linear buckets,
+///  which bounds the relative error of a recorded value to 1/`SUB_BUCKETS` over the full 64-bit range, while using
+///  a fixed amount of storage.
+///
+class latency_histogram final {
+public:
+  static constexpr std::size_t SUB_BUCKET_BITS{4};
+  static constexpr std::size_t SUB_BUCKETS{std::size_t{1} << SUB_BUCKET_BITS};
+  static constexpr std::size_t NUM_BUCKETS{SUB_BUCKETS + ((64 - SUB_BUCKET_BITS) * SUB_BUCKETS)};
+
+  ///
+  /// Get the bucket index for a value.
+  ///
+  /// \param value The value in nanoseconds.
+  ///
+  /// \returns The bucket index.
+  ///
+  [[nodiscard]] static constexpr std::size_t bucket_index(std::uint64_t value) noexcept {
+    if (value < SUB_BUCKETS) {
+      return value;
+    }
+
+    const auto magnitude{static_cast<std::size_t>(63 - std::countl_zero(value))};
+    const auto shift{magnitude - SUB_BUCKET_BITS};
+    const auto sub_bucket{(value >> shift) - SUB_BUCKETS};
+
+    return SUB_BUCKETS + (shift * SUB_BUCKETS) + sub_bucket;
+  }
+
+  ///
+  /// Get the highest value that is recorded in a bucket.
+  ///
+  /// \param index The bucket index.
+  ///
+  /// \returns The highest value in nanoseconds that maps onto the bucket.
+  ///
+  [[nodiscard]] static constexpr std::uint64_t bucket_upper_bound(std::size_t index) noexcept {
+    if (index < SUB_BUCKETS) {
+      return index;
+    }
+
+    const auto shift{(index - SUB_BUCKETS) / SUB_BUCKETS};
+    const auto sub_bucket{(index - SUB_BUCKETS) % SUB_BUCKETS};
+    const std::uint64_t lower_bound{(SUB_BUCKETS + sub_bucket) << shift};
+
+    return lower_bound + ((std::uint64_t{1} << shift) - 1);
+  }
+
+private:
+  std::array<std::uint64_t, NUM_BUCKETS> counts_{};
+  std::uint64_t                          count_{};
+
+public:
+  ///
+  /// Record a value.
+  ///
+  /// \param value The value to record. Negative values are recorded as zero.
+  ///
+  void record(std::chrono::nanoseconds value) noexcept {
+    add(bucket_index(static_cast<std::uint64_t>(std::max(value.count(), std::int64_t{}))), 1);
+  }
+
+  ///
+  /// Add a count to a bucket.
+  ///
+  /// \param index The bucket index.
+  /// \param count The count to add.
+  ///
+  void add(std::size_t index, std::uint64_t count) noexcept {
+    counts_[index] += count;
+    count_ += count;
+  }
+
+  ///
+  /// Merge another histogram into this histogram.
+  ///
+  latency_histogram& operator+=(const latency_histogram& other) noexcept {
+    for (std::size_t i{}; i < NUM_BUCKETS; i++) {
+      counts_[i] += other.counts_[i];
+    }
+
+    count_ += other.count_;
+
+    return *this;
+  }
+
+  ///
+  /// Get the number of recorded values.
+  ///
+  /// \returns The number of recorded values.
+  ///
+  [[nodiscard]] std::uint64_t count() const noexcept {
+    return count_;
+  }
+
+  ///
+  /// Get a percentile value.
+  ///
+  /// \param percentile The percentile, in range 0..100 (e.g. 99.9).
+  ///
+  /// \returns The (bucket upper bound) value at or below which the given percentage of recorded values lies. Zero if
+  ///           no values were recorded.
+  ///
+  /// \throws `std::out_of_range` if the percentile is not in range 0..100.
+  ///
+  [[nodiscard]] std::chrono::nanoseconds percentile(double percentile) const {
+    if (!(percentile >= 0.0) || (percentile > 100.0)) {
+      throw std::out_of_range("Percentile must be in range 0..100");
+    }
+
+    if (count_ == 0) {
+      return {};
+    }
+
+    const auto rank{std::max(
+      static_cast<std::uint64_t>(std::ceil((percentile / 100.0) * static_cast<double>(count_))), std::uint64_t{1})};
+
+    std::uint64_t accumulated{};
+    for (std::size_t i{}; i < NUM_BUCKETS; i++) {
+      accumulated += counts_[i];
+
+      if (accumulated >= rank) {
+        return to_duration(bucket_upper_bound(i));
+      }
+    }
+
+    return to_duration(bucket_upper_bound(NUM_BUCKETS - 1));
+  }
+
+  ///
+  /// Get the maximum recorded value.
+  ///
+  /// \returns The (bucket upper bound) maximum value. Zero if no values were recorded.
+  ///
+  [[nodiscard]] std::chrono::nanoseconds max() const noexcept {
+    for (auto i{NUM_BUCKETS}; i > 0; i--) {
+      if (counts_[i - 1] != 0) {
+        return to_duration(bucket_upper_bound(i - 1));
+      }
+    }
+
+    return {};
+  }
+
+private:
+  [[nodiscard]] static std::chrono::nanoseconds to_duration(std::uint64_t value) noexcept {
+    constexpr auto MAX{static_cast<std::uint64_t>(std::numeric_limits<std::chrono::nanoseconds::rep>::max())};
+    return std::chrono::nanoseconds{static_cast<std::chrono::nanoseconds::rep>(std::min(value, MAX))};
+  }
+};
+
+namespace detail {
+
+///
+/// Latency histogram that is recorded without locks. Recording uses relaxed atomics, so a single histogram can be
+///  written by its owning thread while being read concurrently for a snapshot.
+///
+class atomic_latency_histogram final {
+  std::array<std::atomic<std::uint64_t>, latency_histogram::NUM_BUCKETS> counts_{};
+
+public:
+  void record(std::chrono::nanoseconds value) noexcept {
+    const auto nanoseconds{static_cast<std::uint64_t>(std::max(value.count(), std::int64_t{}))};
+    counts_[latency_histogram::bucket_index(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] latency_histogram snapshot() const noexcept {
+    latency_histogram result;
+
+    for (std::size_t i{}; i < counts_.size(); i++) {
+      if (const auto count{counts_[i].load(std::memory_order_relaxed)}; count != 0) {
+        result.add(i, count);
+      }
+    }
+
+    return result;
+  }
+};
+
+} // namespace detail
+
+} // namespace v1
+
+} // namespace ts
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <iterator>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "cache_line.hpp"
+
+namespace ts {
+
+inline namespace v1 {
+
+///
+/// Unbounded thread-safe queue (FIFO), used as a global queue that absorbs work the bounded queues cannot hold.
+///
+/// Consumers are expected to poll the queue periodically. As most polls find the queue empty, the current size is
+///  kept in an atomic on a separate cache line: size and empty checks are a single relaxed load that does not interfere
+///  with the lock. Elements can be pushed and popped in batches, to amortize the cost of taking the lock.
+///
+/// \param T The queue element value type.
+///
+template<typename T>
+class alignas(cache_line_size) injection_queue final {
+  alignas(cache_line_size) std::atomic<std::size_t> size_{};
+  alignas(cache_line_size) std::mutex               mutex_;
+  std::pmr::deque<T>                                queue_;
+
+public:
+  injection_queue() = default;
+
+  ///
+  /// Constructor.
+  ///
+  /// \param resource The memory resource to allocate the queue storage from. Must outlive the queue.
+  ///
+  explicit injection_queue(std::pmr::memory_resource* resource)
+    : queue_{resource} {
+  }
+
+  injection_queue(injection_queue& other) noexcept      = delete;
+  injection_queue& operator=(injection_queue&) noexcept = delete;
+
+  ///
+  /// Get the current queue size.
+  ///
+  /// \returns The current queue length.
+  ///
+  [[nodiscard]] std::size_t size() const {
+    return size_.load(std::memory_order_relaxed);
+  }
+
+  ///
+  /// Check if the queue is empty.
+  ///
+  /// \returns `true` if the queue is empty, `false` if otherwise.
+  ///
+  [[nodiscard]] bool empty() const {
+    return (size() == 0);
+  }
+
+  ///
+  /// Push a new element into the back of the queue.
+  ///
+  /// \param element The element to push on the queue.
+  ///
+  template<typename U>
+  void push(U&& element) {
+    std::unique_lock lock{mutex_};
+
+    queue_.push_back(std::forward<U>(element));
+    size_.store(queue_.size(), std::memory_order_relaxed);
+  }
+
+  ///
+  /// Push a number of elements into the back of the queue.
+  ///
+  /// \param elements The elements to push on the queue, in queue order.
+  ///
+  void push_bulk(std::vector<T>&& elements) {
+    if (elements.empty()) {
+      return;
+    }
+
+    std::unique_lock lock{mutex_};
+
+    std::move(elements.begin(), elements.end(), std::back_inserter(queue_));
+    size_.store(queue_.size(), std::memory_order_relaxed);
+  }
+
+  ///
+  /// Pop an element off the front of the queue.
+  ///
+  /// \returns An optional element. The optional is empty if the queue was empty.
+  ///
+  [[nodiscard]] std::optional<T> pop() {
+    std::optional<T> result;
+
+    if (empty()) {
+      return result; // Avoid taking the lock when polling an empty queue.
+    }
+
+    std::unique_lock lock{mutex_};
+
+    if (queue_.empty()) {
+      return result;
+    }
+
+    result = std::move(queue_.front());
+    queue_.pop_front();
+    size_.store(queue_.size(), std::memory_order_relaxed);
+
+    return result;
+  }
+
+  ///
+  /// Pop a number of elements off the front of the queue.
+  ///
+  /// \param count The maximum number of elements to pop.
+  ///
+  /// \returns The popped elements, in queue order. Holds less than `count` elements if the queue held less.
+  ///
+  [[nodiscard]] std::vector<T> pop_bulk(std::size_t count) {
+    std::vector<T> result;
+
+    if (empty()) {
+      return result; // Avoid taking the lock when polling an empty queue.
+    }
+
+    std::unique_lock lock{mutex_};
+
+    const auto last{queue_.begin() + static_cast<std::ptrdiff_t>(std::min(count, queue_.size()))};
+
+    result.reserve(static_cast<std::size_t>(last - queue_.begin()));
+    std::move(queue_.begin(), last, std::back_inserter(result));
+    queue_.erase(queue_.begin(), last);
+    size_.store(queue_.size(), std::memory_order_relaxed);
+
+    return result;
+  }
+
+  ///
+  /// Flush the queue, removing all elements.
+  ///
+  /// \returns The number of elements removed.
+  ///
+  std::size_t flush() {
+    std::unique_lock lock{mutex_};
+    const auto size{queue_.size()};
+
+    queue_.clear();
+    size_.store(0, std::memory_order_relaxed);
+
+    return size;
+  }
+};
+
+} // namespace v1
+
+} // namespace ts
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "cache_line.hpp"
+#include "histogram.hpp"
+
+namespace ts {
+
+inline namespace v1 {
+
+///
+/// Compile-time switch for the scheduler runtime metrics. Define `TS_ENABLE_METRICS` to enable metrics collection.
+///  When disabled, metrics collection is removed from the scheduler hot paths entirely.
+///
+#ifdef TS_ENABLE_METRICS
+static constexpr bool metrics_enabled{true};
+#else
+static constexpr bool metrics_enabled{false};
+#endif
+
+///
+/// Runtime metrics of a single executor.
+///
+struct executor_metrics {
+  std::uint64_t            tasks_executed{};  ///< Number of tasks run (including tasks run while waiting).
+  std::uint64_t            steals{};          ///< Number of tasks taken from another executors' queue.
+  std::uint64_t            failed_steals{};   ///< Number of pops that found all queues empty.
+  std::uint64_t            parks{};           ///< Number of times the executor went to sleep for lack of work.
+  std::uint64_t            unparks{};         ///< Number of times the executor woke up.
+  std::chrono::nanoseconds busy_time{};       ///< Time spent processing tasks.
+  std::chrono::nanoseconds idle_time{};       ///< Time spent sleeping for lack of work.
+  std::size_t              queue_depth{};     ///< Queue occupation at the moment of the snapshot.
+  latency_histogram        queue_delay;       ///< Time from scheduling a task until an executor picks it up.
+  latency_histogram        execution_time;    ///< Time spent running a task.
+  std::uint64_t            deadline_misses{}; ///< Number of tasks with a deadline picked up after their deadline.
+
+  executor_metrics& operator+=(const executor_metrics& other) noexcept {
+    tasks_executed += other.tasks_executed;
+    steals += other.steals;
+    failed_steals += other.failed_steals;
+    parks += other.parks;
+    unparks += other.unparks;
+    busy_time += other.busy_time;
+    idle_time += other.idle_time;
+    queue_depth += other.queue_depth;
+    queue_delay += other.queue_delay;
+    execution_time += other.execution_time;
+    deadline_misses += other.deadline_misses;
+
+    return *this;
+  }
+};
+
+///
+/// Runtime metrics snapshot of a scheduler.
+///
+struct scheduler_metrics {
+  std::vector<executor_metrics> executors;               ///< Metrics per executor, indexed by executor ID.
+  std::uint64_t                 schedule_rejections{};   ///< Number of tasks rejected because the queues were full.
+  std::size_t                   injection_queue_depth{}; ///< Injection queue occupation at the moment of the snapshot.
+
+  ///
+  /// Get the metrics accumulated over all executors.
+  ///
+  /// \returns The accumulated executor metrics.
+  ///
+  [[nodiscard]] executor_metrics total() const noexcept {
+    executor_metrics result;
+
+    for (const auto& executor : executors) {
+      result += executor;
+    }
+
+    return result;
+  }
+};
+
+namespace detail {
+
+struct no_timestamp {};
+
+///
+/// Timestamp type for metrics: only holds a time point when metrics are enabled.
+///
+using metrics_timestamp = std::conditional_t<metrics_enabled, std::chrono::steady_clock::time_point, no_timestamp>;
+
+template<typename Timestamp = metrics_timestamp>
+[[nodiscard]] Timestamp metrics_now() noexcept {
+  if constexpr (std::is_same_v<Timestamp, no_timestamp>) {
+    return {};
+  } else {
+    return std::chrono::steady_clock::now();
+  }
+}
+
+///
+/// Metrics counters of a single executor. Every executor owns a set of counters on its own cache line(s), so updating
+///  them does not cause contention. All counters are relaxed atomics, as they are only read for snapshots. The latency
+///  histograms are kept apart from the frequently updated counters.
+///
+class alignas(cache_line_size) executor_counters final {
+  std::atomic<std::uint64_t> tasks_executed_{};
+  std::atomic<std::uint64_t> steals_{};
+  std::atomic<std::uint64_t> failed_steals_{};
+  std::atomic<std::uint64_t> parks_{};
+  std::atomic<std::uint64_t> unparks_{};
+  std::atomic<std::int64_t>  busy_ns_{};
+  std::atomic<std::int64_t>  idle_ns_{};
+  std::atomic<std::uint64_t> deadline_misses_{};
+
+  alignas(cache_line_size) atomic_latency_histogram queue_delay_;
+  atomic_latency_histogram                          execution_time_;
+
+public:
+  void count_pop(bool popped, bool stolen) noexcept {
+    if (!popped) {
+      failed_steals_.fetch_add(1, std::memory_order_relaxed);
+    } else if (stolen) {
+      steals_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  void count_task() noexcept {
+    tasks_executed_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void count_busy(std::chrono::nanoseconds duration) noexcept {
+    busy_ns_.fetch_add(duration.count(), std::memory_order_relaxed);
+  }
+
+  void count_queue_delay(std::chrono::nanoseconds delay) noexcept {
+    queue_delay_.record(delay);
+  }
+
+  void count_execution_time(std::chrono::nanoseconds duration) noexcept {
+    execution_time_.record(duration);
+  }
+
+  void count_park() noexcept {
+    parks_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void count_unpark(std::chrono::nanoseconds idle_duration) noexcept {
+    unparks_.fetch_add(1, std::memory_order_relaxed);
+    idle_ns_.fetch_add(idle_duration.count(), std::memory_order_relaxed);
+  }
+
+  void count_deadline_miss() noexcept {
+    deadline_misses_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] executor_metrics snapshot() const noexcept {
+    return {tasks_executed_.load(std::memory_order_relaxed),
+            steals_.load(std::memory_order_relaxed),
+            failed_steals_.load(std::memory_order_relaxed),
+            parks_.load(std::memory_order_relaxed),
+            unparks_.load(std::memory_order_relaxed),
+            std::chrono::nanoseconds{busy_ns_.load(std::memory_order_relaxed)},
+            std::chrono::nanoseconds{idle_ns_.load(std::memory_order_relaxed)},
+            {},
+            queue_delay_.snapshot(),
+            execution_time_.snapshot(),
+            deadline_misses_.load(std::memory_order_relaxed)};
+  }
+};
+
+} // namespace detail
+
+} // namespace v1
+
+} // namespace ts
@@ -0,0 +1,223 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "cache_line.hpp"
+
+namespace ts {
+
+inline namespace v1 {
+
+///
+/// Thread-safe intrusive queue (FIFO) for multiple producers and a single consumer at a time.
+///
+/// Every element is stored in a node that carries the link to the next node (Vyukov's MPSC queue). A push links its
+///  node using a single atomic exchange on the queue head, without taking a lock and without any container storage
+///  to grow. The nodes are allocated from the memory resource of the queue, so with a `pool_resource` no heap alloca-
+///  tions are made once the pool is warm.
+///
+/// Consumers are serialized by a lock that producers never take. The owner of the queue pops using `pop`, while other
+///  consumers (e.g. work stealing) use `try_pop`, which gives up instead of waiting when the queue is being consumed.
+///
+/// While a push is in progress, the elements pushed after it cannot be popped until it completes. In that case a pop
+///  returns no element, even though the size is non-zero.
+///
+/// \param T       The queue element value type.
+/// \param MaxSize The maximum queue size.
+///
+template<typename T, std::size_t MaxSize>
+requires(MaxSize > 0) class alignas(cache_line_size) mpsc_queue final {
+  struct node {
+    std::atomic<node*> next_{};
+    std::optional<T>   value_{};
+
+    node() = default;
+
+    template<typename U>
+    explicit node(std::in_place_t, U&& value)
+      : value_{std::in_place, std::forward<U>(value)} {
+    }
+  };
+
+  alignas(cache_line_size) std::atomic<std::size_t> size_{};
+  alignas(cache_line_size) std::atomic<node*>       head_{}; // Last pushed node, exchanged by the producers.
+  alignas(cache_line_size) std::mutex               mutex_;
+  node*                                             tail_{}; // Last popped node (the stub), owned by the consumer.
+  std::pmr::polymorphic_allocator<>                 allocator_;
+
+  [[nodiscard]] std::optional<T> pop_locked() {
+    auto* tail{tail_};
+    auto* next{tail->next_.load(std::memory_order_acquire)};
+
+    if (next == nullptr) {
+      return {};
+    }
+
+    // The popped node becomes the new stub.
+    std::optional<T> result{std::move(next->value_)};
+    next->value_.reset();
+    tail_ = next;
+
+    allocator_.delete_object(tail);
+    size_.fetch_sub(1, std::memory_order_relaxed);
+
+    return result;
+  }
+
+public:
+  mpsc_queue()
+    : mpsc_queue{std::pmr::get_default_resource()} {
+  }
+
+  ///
+  /// Constructor.
+  ///
+  /// \param resource The memory resource to allocate the nodes from. Must outlive the queue.
+  ///
+  explicit mpsc_queue(std::pmr::memory_resource* resource)
+    : allocator_{resource} {
+    tail_ = allocator_.new_object<node>();
+    head_.store(tail_, std::memory_order_relaxed);
+  }
+
+  mpsc_queue(mpsc_queue& other) noexcept      = delete;
+  mpsc_queue& operator=(mpsc_queue&) noexcept = delete;
+
+  ~mpsc_queue() {
+    while (pop_locked()) {
+    }
+
+    allocator_.delete_object(tail_);
+  }
+
+  ///
+  /// Get the maximum queue size.
+  ///
+  /// \returns The maximum queue length.
+  ///
+  [[nodiscard]] static constexpr std::size_t max_size() noexcept {
+    return MaxSize;
+  }
+
+  ///
+  /// Get the current queue size, including pushes in progress.
+  ///
+  /// \returns The current queue length.
+  ///
+  [[nodiscard]] std::size_t size() const {
+    return size_.load(std::memory_order_relaxed);
+  }
+
+  ///
+  /// Check if the queue is empty.
+  ///
+  /// \returns `true` if the queue is empty, `false` if otherwise.
+  ///
+  [[nodiscard]] bool empty() const {
+    return (size() == 0);
+  }
+
+  ///
+  /// Push a new element into the back of the queue.
+  ///
+  /// \param element The element to push on the queue. It is left untouched if the queue does not accept it.
+  ///
+  /// \returns `true` if the element is accepted, `false` if the queue could not accept the element (because maximum
+  ///           occupation capacity is reached).
+  ///
+  template<typename U>
+  [[nodiscard]] bool push(U&& element) {
+    if (size_.fetch_add(1, std::memory_order_relaxed) >= MaxSize) {
+      size_.fetch_sub(1, std::memory_order_relaxed);
+      return false;
+    }
+
+    node* pushed{};
+
+    try {
+      pushed = allocator_.new_object<node>(std::in_place, std::forward<U>(element));
+    } catch (...) {
+      size_.fetch_sub(1, std::memory_order_relaxed);
+      throw;
+    }
+
+    head_.exchange(pushed, std::memory_order_acq_rel)->next_.store(pushed, std::memory_order_release);
+
+    return true;
+  }
+
+  ///
+  /// Pop an element off the front of the queue, waiting for other consumers to finish.
+  ///
+  /// \returns An optional element. The optional is empty if the queue was empty.
+  ///
+  [[nodiscard]] std::optional<T> pop() {
+    std::unique_lock lock{mutex_};
+    return pop_locked();
+  }
+
+  ///
+  /// Pop an element off the front of the queue, unless it is being consumed by another consumer.
+  ///
+  /// \returns An optional element. The optional is empty if the queue was empty, or in use by another consumer.
+  ///
+  [[nodiscard]] std::optional<T> try_pop() {
+    std::unique_lock lock{mutex_, std::try_to_lock};
+
+    if (!lock.owns_lock()) {
+      return {};
+    }
+
+    return pop_locked();
+  }
+
+  ///
+  /// Pop a number of elements off the front of the queue.
+  ///
+  /// \param count The maximum number of elements to pop.
+  ///
+  /// \returns The popped elements, in queue order. Holds less than `count` elements if the queue held less.
+  ///
+  [[nodiscard]] std::vector<T> pop_bulk(std::size_t count) {
+    std::unique_lock lock{mutex_};
+    std::vector<T>   result;
+
+    while (result.size() < count) {
+      auto element{pop_locked()};
+
+      if (!element) {
+        break;
+      }
+
+      result.push_back(std::move(*element));
+    }
+
+    return result;
+  }
+
+  ///
+  /// Flush the queue, removing all elements.
+  ///
+  /// \returns The number of elements removed.
+  ///
+  std::size_t flush() {
+    std::unique_lock lock{mutex_};
+    std::size_t      count{};
+
+    while (pop_locked()) {
+      count++;
+    }
+
+    return count;
+  }
+};
+
+} // namespace v1
+
+} // namespace ts
@@ -1,14 +1,23 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
 #include <cstddef>
+#include <cstdint>
 #include <deque>
+#include <memory>
+#include <memory_resource>
 #include <numeric>
 #include <optional>
 #include <queue>
 #include <stdexcept>
 #include <string>
+#include <utility>
+#include <vector>
 
+#include "cache_line.hpp"
 #include "safe_queue.hpp"
 
 namespace ts {
@@ -20,39 +29,147 @@ inline namespace v1 {
 ///
 /// This type features an API similar to a single queue. For any item push, the load is uniformly distributed over the
 ///  internal queues. The pop call is called with an index to indicate the internal queue index. However, when the in-
-///  dexed queue is empty, data is 'stolen' from the next non-empty queue (work stealing).
+///  dexed queue is empty, data is 'stolen' from the next non-empty queue (work stealing). Optionally, queues can be
+///  assigned to groups (e.g. NUMA nodes), in which case queues within the same group are preferred for stealing.
+///
+/// The internal queues are cache line aligned, and the sink cursor (shared by all pushing threads) is kept on its own
+///  cache line, to avoid false sharing between threads working on different queues. An atomic occupancy counter is
+///  maintained for cheap (approximate) size and empty checks.
+///
+/// An atomic bitmap holds a bit per queue that is set on push, and cleared when the queue drains. Work stealing looks
+///  up non-empty victims in the bitmap (a find-first-set per 64 queues), so the cost of finding work does not grow with
+///  the number of empty queues.
+///
+/// The uniform load distribution can be restricted to the first N queues (the active queues, see
+///  `set_num_active_queues`). Elements in inactive queues remain available for work stealing, and can be moved to the
+///  active queues using `migrate`.
+///
+/// The underlying queue type can be replaced, e.g. by an `mpsc_queue` to push without locking. If the queue type has a
+///  `try_pop`, it is used for work stealing, so thieves skip queues that are being consumed instead of waiting.
 ///
 /// \param T            The queue element value type.
 /// \param MaxQueueSize The maximum queue size. Must be in range `1..MAX_SIZE_LIMIT` (limit for a single queue).
+/// \param Queue        The underlying queue type.
 ///
-template<typename T, std::size_t MaxQueueSize>
+template<typename T, std::size_t MaxQueueSize, typename Queue = safe_queue<T, MaxQueueSize>>
 class multiqueue final {
-  using queue_t    = safe_queue<T, MaxQueueSize>;
-  using queues     = std::deque<queue_t>;
-  using queue_iter = typename queues::iterator;
+  using queue_t = Queue;
+  using queues  = std::deque<queue_t>;
 
   static constexpr std::size_t MAX_NUMBER_OF_QUEUES{1024};
+  static constexpr std::size_t WORD_BITS{64};
+  static constexpr std::size_t NUM_WORDS{MAX_NUMBER_OF_QUEUES / WORD_BITS};
+
+  using bitmap = std::array<std::atomic<std::uint64_t>, NUM_WORDS>;
+
+  queues                                               queues_;
+  std::vector<unsigned int>                            groups_;
+  std::atomic<std::size_t>                             num_active_queues_{};
+  alignas(cache_line_size) std::atomic<std::size_t>    sink_cursor_{};
+  alignas(cache_line_size) std::atomic<std::ptrdiff_t> occupancy_{};
+  alignas(cache_line_size) bitmap                      occupied_{};
+
+  [[nodiscard]] static constexpr std::uint64_t bit_of(std::size_t index) noexcept {
+    return std::uint64_t{1} << (index % WORD_BITS);
+  }
+
+  void mark_occupied(std::size_t index) noexcept {
+    occupied_[index / WORD_BITS].fetch_or(bit_of(index), std::memory_order_release);
+  }
+
+  void update_occupied(std::size_t index) noexcept {
+    auto& word{occupied_[index / WORD_BITS]};
+
+    if (((word.load(std::memory_order_relaxed) & bit_of(index)) == 0) || !queues_[index].empty()) {
+      return;
+    }
+
+    // A push that completes concurrently either sets its bit after this clear, or is observed by the recheck (the
+    //  clear synchronizes with the set).
+    word.fetch_and(~bit_of(index), std::memory_order_acq_rel);
+
+    if (!queues_[index].empty()) {
+      mark_occupied(index);
+    }
+  }
+
+  [[nodiscard]] bool count_push(std::size_t index, bool pushed) noexcept {
+    if (pushed) {
+      occupancy_.fetch_add(1, std::memory_order_relaxed);
+      mark_occupied(index);
+    }
 
-  queues     queues_;
-  queue_iter sink_cursor_;
+    return pushed;
+  }
 
-  void advance_sink_cursor() {
-    if (++sink_cursor_ == queues_.end()) {
-      sink_cursor_ = queues_.begin();
+  void copy_occupied(const bitmap& other) noexcept {
+    for (std::size_t i{}; i < NUM_WORDS; i++) {
+      occupied_[i].store(other[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
     }
   }
 
-  [[nodiscard]] bool is_current_sink_full() const {
-    return (sink_cursor_->size() >= MaxQueueSize);
+  [[nodiscard]] std::optional<std::size_t> advance_sink() {
+    const auto num_active_queues{num_active_queues_.load(std::memory_order_relaxed)};
+
+    for (std::size_t advance_count{}; advance_count < num_active_queues; advance_count++) {
+      if (const auto sink{sink_cursor_.fetch_add(1, std::memory_order_relaxed) % num_active_queues};
+          queues_[sink].size() < MaxQueueSize) {
+        return sink;
+      }
+    }
+
+    return {};
   }
 
-  [[nodiscard]] bool advance_sink() {
-    std::size_t advance_count{};
-    do {
-      advance_sink_cursor();
-    } while (is_current_sink_full() && (advance_count++ < queues_.size()));
+  [[nodiscard]] std::size_t select_source(std::size_t index) const {
+    if (!queues_[index].empty()) {
+      return index;
+    }
+
+    // Visit the occupied queues round-robin, starting after the indexed queue: the words from the one holding the
+    //  start bit, wrapping around to the bits before the start bit in that same word.
+    const auto start{(index + 1) % queues_.size()};
+    const auto num_words{(queues_.size() + WORD_BITS - 1) / WORD_BITS};
+    const auto start_mask{~std::uint64_t{} << (start % WORD_BITS)};
+
+    const auto select = [&](auto&& predicate) {
+      for (std::size_t i{}; i <= num_words; i++) {
+        const auto word{(start / WORD_BITS + i) % num_words};
+        auto       bits{occupied_[word].load(std::memory_order_acquire)};
+
+        if (i == 0) {
+          bits &= start_mask;
+        } else if (i == num_words) {
+          bits &= ~start_mask;
+        }
+
+        for (; bits != 0; bits &= (bits - 1)) {
+          const auto victim{word * WORD_BITS + static_cast<std::size_t>(std::countr_zero(bits))};
+
+          if ((victim != index) && predicate(victim) && !queues_[victim].empty()) {
+            return victim;
+          }
+        }
+      }
+
+      return index;
+    };
+
+    if (!groups_.empty()) {
+      if (const auto victim{select([&](std::size_t v) { return (groups_[v] == groups_[index]); })}; victim != index) {
+        return victim;
+      }
+    }
+
+    return select([](std::size_t) { return true; });
+  }
 
-    return (advance_count < queues_.size());
+  [[nodiscard]] std::optional<T> steal(std::size_t victim) {
+    if constexpr (requires(queue_t& queue) { queue.try_pop(); }) {
+      return queues_[victim].try_pop();
+    } else {
+      return queues_[victim].pop();
+    }
   }
 
 public:
@@ -61,7 +178,30 @@ public:
   ///
   /// \param num_queues The number of underlying queues to instantiate.
   ///
-  explicit multiqueue(std::size_t num_queues) {
+  explicit multiqueue(std::size_t num_queues)
+    : multiqueue{std::allocator_arg, std::pmr::get_default_resource(), num_queues} {
+  }
+
+  ///
+  /// Constructor.
+  ///
+  /// \param num_queues The number of underlying queues to instantiate.
+  /// \param groups     The group index per queue. When a queue is empty, work is preferably stolen from queues with
+  ///                    the same group index.
+  ///
+  /// \throws `std::invalid_argument` if the number of group indices does not match the number of queues.
+  ///
+  multiqueue(std::size_t num_queues, std::vector<unsigned int> groups)
+    : multiqueue{std::allocator_arg, std::pmr::get_default_resource(), num_queues, std::move(groups)} {
+  }
+
+  ///
+  /// Constructor, allocating the storage of the underlying queues from a memory resource.
+  ///
+  /// \param resource   The memory resource to allocate from. Must outlive the multiqueue.
+  /// \param num_queues The number of underlying queues to instantiate.
+  ///
+  multiqueue(std::allocator_arg_t, std::pmr::memory_resource* resource, std::size_t num_queues) {
     if (num_queues == 0) {
       throw std::underflow_error("Number of queues must be non-zero");
     }
@@ -70,13 +210,51 @@ public:
       throw std::overflow_error("Number of queues must be <" + std::to_string(MAX_NUMBER_OF_QUEUES));
     }
 
-    queues_.resize(num_queues);
+    for (std::size_t i{}; i < num_queues; i++) {
+      queues_.emplace_back(resource);
+    }
+
+    num_active_queues_.store(num_queues, std::memory_order_relaxed);
+  }
+
+  ///
+  /// Constructor, allocating the storage of the underlying queues from a memory resource.
+  ///
+  /// \param resource   The memory resource to allocate from. Must outlive the multiqueue.
+  /// \param num_queues The number of underlying queues to instantiate.
+  /// \param groups     The group index per queue (see the constructor without memory resource).
+  ///
+  /// \throws `std::invalid_argument` if the number of group indices does not match the number of queues.
+  ///
+  multiqueue(std::allocator_arg_t, std::pmr::memory_resource* resource, std::size_t num_queues,
+             std::vector<unsigned int> groups)
+    : multiqueue{std::allocator_arg, resource, num_queues} {
+    if (groups.size() != num_queues) {
+      throw std::invalid_argument("Number of queue groups must match the number of queues");
+    }
+
+    groups_ = std::move(groups);
+  }
 
-    sink_cursor_ = std::prev(queues_.end());
+  multiqueue(multiqueue&& other) noexcept
+    : queues_{std::move(other.queues_)}
+    , groups_{std::move(other.groups_)}
+    , num_active_queues_{other.num_active_queues_.load(std::memory_order_relaxed)}
+    , sink_cursor_{other.sink_cursor_.load(std::memory_order_relaxed)}
+    , occupancy_{other.occupancy_.load(std::memory_order_relaxed)} {
+    copy_occupied(other.occupied_);
   }
 
-  multiqueue(multiqueue&&) noexcept            = default;
-  multiqueue& operator=(multiqueue&&) noexcept = default;
+  multiqueue& operator=(multiqueue&& other) noexcept {
+    queues_ = std::move(other.queues_);
+    groups_ = std::move(other.groups_);
+    num_active_queues_.store(other.num_active_queues_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    sink_cursor_.store(other.sink_cursor_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    occupancy_.store(other.occupancy_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    copy_occupied(other.occupied_);
+
+    return *this;
+  }
 
   ///
   /// Get the maximum queue size.
@@ -87,6 +265,15 @@ public:
     return MaxQueueSize;
   }
 
+  ///
+  /// Get the maximum number of underlying queues.
+  ///
+  /// \returns The maximum number of underlying queues.
+  ///
+  [[nodiscard]] static constexpr std::size_t max_num_queues() noexcept {
+    return MAX_NUMBER_OF_QUEUES;
+  }
+
   ///
   /// Get the number of underlying queues.
   ///
@@ -96,6 +283,36 @@ public:
     return queues_.size();
   }
 
+  ///
+  /// Get the number of active underlying queues: the queues that take part in the uniform load distribution.
+  ///
+  /// \returns The number of active underlying queues.
+  ///
+  [[nodiscard]] std::size_t num_active_queues() const noexcept {
+    return num_active_queues_.load(std::memory_order_relaxed);
+  }
+
+  ///
+  /// Set the number of active underlying queues. The first `num_active_queues` queues will take part in the uniform
+  ///  load distribution. Elements in the other queues remain available for work stealing.
+  ///
+  /// \param num_active_queues The number of active queues.
+  ///
+  /// \throws `std::underflow_error` if the number of active queues is zero.
+  /// \throws `std::out_of_range` if the number of active queues exceeds the number of underlying queues.
+  ///
+  void set_num_active_queues(std::size_t num_active_queues) {
+    if (num_active_queues == 0) {
+      throw std::underflow_error("Number of active queues must be non-zero");
+    }
+
+    if (num_active_queues > queues_.size()) {
+      throw std::out_of_range("Number of active queues exceeds the number of queues");
+    }
+
+    num_active_queues_.store(num_active_queues, std::memory_order_relaxed);
+  }
+
   ///
   /// Get the maximum total capacity: the single queue capacity accumulated for all queues.
   ///
@@ -108,6 +325,8 @@ public:
   ///
   /// Check if the queue is empty.
   ///
+  /// This checks all underlying queues. See `approximate_empty` for a cheaper alternative.
+  ///
   /// \returns `true` if the queue is empty, `false` if otherwise.
   ///
   [[nodiscard]] bool empty() const noexcept {
@@ -117,13 +336,54 @@ public:
   ///
   /// Get the current queue occupation size.
   ///
+  /// This accumulates the sizes of all underlying queues. See `approximate_size` for a cheaper alternative.
+  ///
   /// \returns The number of elements in the queue.
   ///
   [[nodiscard]] std::size_t size() const noexcept {
-    return std::accumulate(queues_.begin(), queues_.end(), 0u,
+    return std::accumulate(queues_.begin(), queues_.end(), std::size_t{},
                            [](const auto& size, const auto& queue) { return (size + queue.size()); });
   }
 
+  ///
+  /// Get the current occupation size of a single underlying queue.
+  ///
+  /// \param index Underlying queue index.
+  ///
+  /// \returns The number of elements in the indexed queue.
+  ///
+  /// \throws `std::out_of_range` if the queue index is out of range.
+  ///
+  [[nodiscard]] std::size_t queue_size(std::size_t index) const {
+    if (index >= queues_.size()) {
+      throw std::out_of_range("Queue index out of range");
+    }
+
+    return queues_[index].size();
+  }
+
+  ///
+  /// Check if the queue is empty, using the occupancy counter (a single atomic load).
+  ///
+  /// The result may lag behind concurrent pushes and pops, but is exact when there are none.
+  ///
+  /// \returns `true` if the queue is (approximately) empty, `false` if otherwise.
+  ///
+  [[nodiscard]] bool approximate_empty() const noexcept {
+    return (approximate_size() == 0);
+  }
+
+  ///
+  /// Get the current queue occupation size, using the occupancy counter (a single atomic load).
+  ///
+  /// The result may lag behind concurrent pushes and pops, but is exact when there are none.
+  ///
+  /// \returns The (approximate) number of elements in the queue.
+  ///
+  [[nodiscard]] std::size_t approximate_size() const noexcept {
+    return static_cast<std::size_t>(std::max(occupancy_.load(std::memory_order_relaxed), std::ptrdiff_t{}));
+  }
+
   ///
   /// Push a new element into the back of the queue.
   ///
@@ -134,51 +394,191 @@ public:
   ///
   template<typename U>
   [[nodiscard]] bool push(U&& element) {
-    if (!advance_sink()) {
+    const auto sink{advance_sink()};
+
+    if (!sink) {
       return false;
     }
 
-    return sink_cursor_->push(std::forward<U>(element));
+    return count_push(*sink, queues_[*sink].push(std::forward<U>(element)));
+  }
+
+  ///
+  /// Push a new element into the back of a specific underlying queue, bypassing the uniform load distribution.
+  ///
+  /// \param index   Underlying queue index to push to.
+  /// \param element The element to push on the queue.
+  ///
+  /// \returns `true` if the element is accepted, `false` if the indexed queue could not accept the element (because
+  ///           maximum occupation capacity is reached).
+  ///
+  /// \throws `std::out_of_range` if the queue index is out of range.
+  ///
+  template<typename U>
+  [[nodiscard]] bool push(std::size_t index, U&& element) {
+    if (index >= queues_.size()) {
+      throw std::out_of_range("Queue index out of range");
+    }
+
+    return count_push(index, queues_[index].push(std::forward<U>(element)));
   }
 
   ///
   /// Pop an element off the front of an underlying queue. Will employ work stealing to select a non-empty queue.
   ///
   /// \param index Underlying queue index to pop from. If the indexed queue is empty, other queues will be checked in
-  ///               a round-robin style to steal work.
+  ///               a round-robin style to steal work. Queues within the same group are checked first.
   ///
   /// \returns An optional element. The optional is empty if all queues were empty.
   ///
   /// \throws `std::out_of_range` if the queue index is out of range.
   ///
   [[nodiscard]] std::optional<T> pop(std::size_t index) {
+    bool stolen{};
+    return pop(index, stolen);
+  }
+
+  ///
+  /// Pop an element off the front of an underlying queue. Will employ work stealing to select a non-empty queue.
+  ///
+  /// \param index  Underlying queue index to pop from. If the indexed queue is empty, other queues will be checked in
+  ///                a round-robin style to steal work. Queues within the same group are checked first.
+  /// \param stolen Set to `true` if the element was stolen from another queue than the indexed queue.
+  ///
+  /// \returns An optional element. The optional is empty if all queues were empty.
+  ///
+  /// \throws `std::out_of_range` if the queue index is out of range.
+  ///
+  [[nodiscard]] std::optional<T> pop(std::size_t index, bool& stolen) {
     if (index >= queues_.size()) {
       throw std::out_of_range("Queue index out of range");
     }
 
-    queue_iter source{queues_.begin() + static_cast<typename queues::difference_type>(index)};
+    const auto source{select_source(index)};
+    auto       element{(source == index) ? queues_[source].pop() : steal(source)};
 
-    if (source->empty()) {
-      std::size_t advance_count{};
-      do {
-        source++;
+    if (element) {
+      occupancy_.fetch_sub(1, std::memory_order_relaxed);
+      update_occupied(source);
+    }
 
-        if (source == queues_.end()) {
-          source = queues_.begin();
-        }
-      } while (source->empty() && (advance_count++ < queues_.size()));
+    stolen = (element && (source != index));
+
+    return element;
+  }
+
+  ///
+  /// Pop an element off the front of an underlying queue, without work stealing.
+  ///
+  /// \param index Underlying queue index to pop from.
+  ///
+  /// \returns An optional element. The optional is empty if the indexed queue was empty.
+  ///
+  /// \throws `std::out_of_range` if the queue index is out of range.
+  ///
+  [[nodiscard]] std::optional<T> pop_local(std::size_t index) {
+    if (index >= queues_.size()) {
+      throw std::out_of_range("Queue index out of range");
+    }
+
+    auto element{queues_[index].pop()};
+
+    if (element) {
+      occupancy_.fetch_sub(1, std::memory_order_relaxed);
+      update_occupied(index);
+    }
+
+    return element;
+  }
+
+  ///
+  /// Pop a number of elements off the front of an underlying queue, without work stealing.
+  ///
+  /// \param index Underlying queue index to pop from.
+  /// \param count The maximum number of elements to pop.
+  ///
+  /// \returns The popped elements, in queue order. Holds less than `count` elements if the indexed queue held less.
+  ///
+  /// \throws `std::out_of_range` if the queue index is out of range.
+  ///
+  [[nodiscard]] std::vector<T> pop_bulk(std::size_t index, std::size_t count) {
+    if (index >= queues_.size()) {
+      throw std::out_of_range("Queue index out of range");
     }
 
-    return source->pop();
+    auto elements{queues_[index].pop_bulk(count)};
+    occupancy_.fetch_sub(static_cast<std::ptrdiff_t>(elements.size()), std::memory_order_relaxed);
+    update_occupied(index);
+
+    return elements;
+  }
+
+  ///
+  /// Move the elements of an inactive underlying queue to the active queues, using the uniform load distribution.
+  ///
+  /// The indexed queue must not be pushed to concurrently.
+  ///
+  /// \param index Underlying queue index to move the elements from.
+  ///
+  /// \returns The number of moved elements. Elements that could not be moved because the active queues are at their
+  ///           maximum capacity remain in the indexed queue. If the active queues fill up concurrently, the element
+  ///           being moved is put back at the end of the indexed queue, after the remaining elements.
+  ///
+  /// \throws `std::out_of_range` if the queue index is out of range.
+  /// \throws `std::invalid_argument` if the indexed queue is active.
+  ///
+  std::size_t migrate(std::size_t index) {
+    if (index >= queues_.size()) {
+      throw std::out_of_range("Queue index out of range");
+    }
+
+    if (index < num_active_queues_.load(std::memory_order_relaxed)) {
+      throw std::invalid_argument("Elements can only be migrated from inactive queues");
+    }
+
+    std::size_t      count{};
+    std::optional<T> element;
+
+    while (const auto sink{advance_sink()}) {
+      if (!element && !(element = queues_[index].pop())) {
+        break;
+      }
+
+      if (!queues_[*sink].push(std::move(*element))) {
+        continue; // The sink filled up concurrently, try the next sink with room.
+      }
+
+      element.reset();
+      mark_occupied(*sink);
+      count++;
+    }
+
+    if (element) {
+      // All active queues filled up concurrently: put the element back, there is room as it was just popped.
+      (void)queues_[index].push(std::move(*element));
+    }
+
+    update_occupied(index);
+
+    return count;
   }
 
   ///
   /// Flush the queue, removing all elements from all queues.
   ///
-  void flush() {
-    for (auto& queue : queues_) {
-      queue.flush();
+  /// \returns The number of elements removed.
+  ///
+  std::size_t flush() {
+    std::size_t count{};
+
+    for (std::size_t i{}; i < queues_.size(); i++) {
+      const auto size{queues_[i].flush()};
+      occupancy_.fetch_sub(static_cast<std::ptrdiff_t>(size), std::memory_order_relaxed);
+      update_occupied(i);
+      count += size;
     }
+
+    return count;
   }
 };
 
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace ts {
+
+inline namespace v1 {
+
+///
+/// Scheduler partition policy.
+///
+/// Executors share their capacity between the partitions with pending work in proportion to the partition `weight`
+///  (the tasks scheduled outside of any partition have a weight of 1). A partition can be restricted to a subset of the
+///  executors by listing their indices in `executors`. If empty, the tasks of the partition may run on any executor.
+///
+struct partition_policy {
+  unsigned int             weight{1};
+  std::vector<std::size_t> executors{};
+};
+
+} // namespace v1
+
+} // namespace ts
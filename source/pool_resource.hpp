@@ -0,0 +1,246 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <mutex>
+
+#include "cache_line.hpp"
+
+namespace ts {
+
+inline namespace v1 {
+
+///
+/// Memory resource pooling small allocations in size classes, tuned for job-sized objects (task storage, completion
+///  data).
+///
+/// Allocations of up to `max_block_size` bytes are rounded up to a power-of-two size class. Every size class keeps its
+///  free blocks in a lock-free stack, so allocation and deallocation take a single compare-and-swap in the common
+///  case. The stack head holds a block number and a tag that is incremented on every pop, which prevents the ABA
+///  problem. Blocks are carved from slabs obtained from the upstream resource, which are only returned when the pool
+///  is destroyed. The links between free blocks are kept in the slab header rather than in the blocks themselves, so
+///  a pop that loses the race never reads a block that is already in use. Larger or over-aligned allocations are
+///  forwarded to the upstream resource, as are the allocations of a size class that has used up its `max_slabs`.
+///
+class pool_resource final : public std::pmr::memory_resource {
+public:
+  static constexpr std::size_t min_block_size{32};
+  static constexpr std::size_t max_block_size{512};
+  static constexpr std::size_t slab_size{64 * 1024};
+  static constexpr std::size_t max_slabs{1024}; // Per size class.
+
+private:
+  static constexpr std::size_t   NUM_CLASSES{std::bit_width(max_block_size / min_block_size)};
+  static constexpr std::uint64_t NUMBER_MASK{0xffff'ffff};
+
+  // Slabs are aligned to their size, so the slab of a block is found by masking the block address. The first blocks
+  //  of a slab form its header: the slab index, followed by the link to the next free block for every block slot.
+  struct size_class {
+    alignas(cache_line_size) std::atomic<std::uint64_t> head_{}; // Tag, and block number + 1 (0 if empty).
+    std::mutex                                          grow_mutex_;
+    std::size_t                                         num_slabs_{};
+    std::array<std::byte*, max_slabs>                   slabs_{};
+    std::atomic<bool>                                   full_{};         // All slabs in use, see `owns`.
+    std::array<std::byte*, max_slabs>                   sorted_slabs_{}; // Set once before `full_`.
+  };
+
+  std::pmr::memory_resource*          upstream_;
+  std::array<size_class, NUM_CLASSES> classes_;
+
+  [[nodiscard]] static constexpr std::size_t class_of(std::size_t size) noexcept {
+    return std::bit_width((std::max(size, min_block_size) - 1) / min_block_size);
+  }
+
+  [[nodiscard]] static constexpr std::size_t block_size(std::size_t index) noexcept {
+    return min_block_size << index;
+  }
+
+  [[nodiscard]] static constexpr std::size_t slots_per_slab(std::size_t index) noexcept {
+    return slab_size / block_size(index);
+  }
+
+  [[nodiscard]] static constexpr std::size_t header_slots(std::size_t index) noexcept {
+    const auto header_size{sizeof(std::uint32_t) * (slots_per_slab(index) + 1)};
+    return (header_size + block_size(index) - 1) / block_size(index);
+  }
+
+  [[nodiscard]] static constexpr std::size_t blocks_per_slab(std::size_t index) noexcept {
+    return slots_per_slab(index) - header_slots(index);
+  }
+
+  [[nodiscard]] std::atomic_ref<std::uint32_t> next_of(std::size_t index, std::uint64_t number) const noexcept {
+    const auto per_slab{blocks_per_slab(index)};
+    auto*      header{reinterpret_cast<std::uint32_t*>(classes_[index].slabs_[number / per_slab])};
+
+    return std::atomic_ref<std::uint32_t>{header[1 + header_slots(index) + number % per_slab]};
+  }
+
+  [[nodiscard]] std::byte* block_at(std::size_t index, std::uint64_t number) const noexcept {
+    const auto per_slab{blocks_per_slab(index)};
+    return classes_[index].slabs_[number / per_slab] + (header_slots(index) + number % per_slab) * block_size(index);
+  }
+
+  [[nodiscard]] static std::uint64_t number_of(std::size_t index, std::byte* block) noexcept {
+    const auto  address{reinterpret_cast<std::uintptr_t>(block)};
+    const auto* header{reinterpret_cast<const std::uint32_t*>(address & ~(std::uintptr_t{slab_size} - 1))};
+
+    return *header * blocks_per_slab(index) + (address % slab_size) / block_size(index) - header_slots(index);
+  }
+
+  void push(std::size_t index, std::uint64_t first, std::uint64_t last) noexcept {
+    auto& target{classes_[index]};
+    auto  head{target.head_.load(std::memory_order_relaxed)};
+
+    do {
+      next_of(index, last).store(static_cast<std::uint32_t>(head & NUMBER_MASK), std::memory_order_relaxed);
+    } while (!target.head_.compare_exchange_weak(head, (head & ~NUMBER_MASK) | (first + 1), std::memory_order_release,
+                                                 std::memory_order_relaxed));
+  }
+
+  [[nodiscard]] std::byte* pop(std::size_t index) noexcept {
+    auto& source{classes_[index]};
+    auto  head{source.head_.load(std::memory_order_acquire)};
+
+    while ((head & NUMBER_MASK) != 0) {
+      const auto number{(head & NUMBER_MASK) - 1};
+      const auto next{next_of(index, number).load(std::memory_order_relaxed)};
+
+      if (source.head_.compare_exchange_weak(head, (((head >> 32) + 1) << 32) | next, std::memory_order_acquire,
+                                             std::memory_order_acquire)) {
+        return block_at(index, number);
+      }
+    }
+
+    return nullptr;
+  }
+
+  [[nodiscard]] std::byte* grow(std::size_t index) {
+    auto&            target{classes_[index]};
+    std::unique_lock lock{target.grow_mutex_};
+
+    // Another thread may have grown the pool in the meantime.
+    if (auto* block{pop(index)}; block != nullptr) {
+      return block;
+    }
+
+    if (target.num_slabs_ >= max_slabs) {
+      return nullptr; // Forwarded to the upstream resource.
+    }
+
+    auto* slab{static_cast<std::byte*>(upstream_->allocate(slab_size, slab_size))};
+    *reinterpret_cast<std::uint32_t*>(slab) = static_cast<std::uint32_t>(target.num_slabs_);
+    target.slabs_[target.num_slabs_++]      = slab;
+
+    if (target.num_slabs_ == max_slabs) {
+      std::ranges::copy(target.slabs_, target.sorted_slabs_.begin());
+      std::ranges::sort(target.sorted_slabs_);
+      target.full_.store(true, std::memory_order_release);
+    }
+
+    // Return the first block, and link the others into a chain that is pushed at once.
+    const auto per_slab{blocks_per_slab(index)};
+    const auto first{(target.num_slabs_ - 1) * per_slab};
+
+    for (std::size_t i{1}; i < (per_slab - 1); i++) {
+      next_of(index, first + i).store(static_cast<std::uint32_t>(first + i + 2), std::memory_order_relaxed);
+    }
+
+    push(index, first + 1, first + per_slab - 1);
+
+    return block_at(index, first);
+  }
+
+  // Check if a block of a size class was allocated from the pool, rather than forwarded because the class was full.
+  [[nodiscard]] bool owns(std::size_t index, void* block) const noexcept {
+    const auto& source{classes_[index]};
+
+    if (!source.full_.load(std::memory_order_acquire)) {
+      return true;
+    }
+
+    const auto slab{reinterpret_cast<std::uintptr_t>(block) & ~(std::uintptr_t{slab_size} - 1)};
+    return std::ranges::binary_search(source.sorted_slabs_, reinterpret_cast<std::byte*>(slab));
+  }
+
+protected:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    if ((bytes > max_block_size) || (alignment > max_block_size)) {
+      return upstream_->allocate(bytes, alignment);
+    }
+
+    // Blocks are aligned to their size.
+    const auto index{class_of(std::max(bytes, alignment))};
+
+    if (auto* block{pop(index)}; block != nullptr) {
+      return block;
+    }
+
+    if (auto* block{grow(index)}; block != nullptr) {
+      return block;
+    }
+
+    return upstream_->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override {
+    if ((bytes > max_block_size) || (alignment > max_block_size)) {
+      upstream_->deallocate(pointer, bytes, alignment);
+      return;
+    }
+
+    const auto index{class_of(std::max(bytes, alignment))};
+
+    if (!owns(index, pointer)) {
+      upstream_->deallocate(pointer, bytes, alignment);
+      return;
+    }
+
+    const auto number{number_of(index, static_cast<std::byte*>(pointer))};
+
+    push(index, number, number);
+  }
+
+  [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    return (this == &other);
+  }
+
+public:
+  ///
+  /// Constructor.
+  ///
+  /// \param upstream The memory resource to obtain the slabs, and the allocations that are not pooled from. Must
+  ///                  support allocations aligned to the slab size.
+  ///
+  explicit pool_resource(std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+    : upstream_{upstream} {
+  }
+
+  pool_resource(const pool_resource&)            = delete;
+  pool_resource& operator=(const pool_resource&) = delete;
+
+  ~pool_resource() override {
+    for (auto& c : classes_) {
+      for (std::size_t i{}; i < c.num_slabs_; i++) {
+        upstream_->deallocate(c.slabs_[i], slab_size, slab_size);
+      }
+    }
+  }
+
+  ///
+  /// Get the upstream memory resource.
+  ///
+  /// \returns A pointer to the upstream memory resource.
+  ///
+  [[nodiscard]] std::pmr::memory_resource* upstream_resource() const noexcept {
+    return upstream_;
+  }
+};
+
+} // namespace v1
+
+} // namespace ts
@@ -1,12 +1,18 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <deque>
+#include <iterator>
+#include <memory_resource>
 #include <memory>
 #include <mutex>
 #include <optional>
-#include <shared_mutex>
 #include <utility>
+#include <vector>
+
+#include "cache_line.hpp"
 
 static constexpr std::size_t MAX_SIZE_LIMIT{8192};
 
@@ -19,17 +25,31 @@ static constexpr std::size_t safe_queue_max_size_limit{MAX_SIZE_LIMIT};
 ///
 /// Thread-safe queue (FIFO).
 ///
+/// The queue is cache line aligned, so that queues placed back to back do not share cache lines. The current size is
+///  kept in an atomic on a separate cache line, so that size and empty checks are lock-free and do not interfere with
+///  the lock of a queue in use.
+///
 /// \param T       The queue element value type.
 /// \param MaxSize The maximum queue size. Must be in range 1..MAX_SIZE_LIMIT.
 ///
 template<typename T, std::size_t MaxSize>
-requires((MaxSize > 0) && (MaxSize <= MAX_SIZE_LIMIT)) class safe_queue final {
-  std::deque<T>             queue_;
-  mutable std::shared_mutex mutex_;
+requires((MaxSize > 0) && (MaxSize <= MAX_SIZE_LIMIT)) class alignas(cache_line_size) safe_queue final {
+  alignas(cache_line_size) std::atomic<std::size_t> size_{};
+  alignas(cache_line_size) std::mutex               mutex_;
+  std::pmr::deque<T>                                queue_;
 
 public:
   safe_queue() = default;
 
+  ///
+  /// Constructor.
+  ///
+  /// \param resource The memory resource to allocate the queue storage from. Must outlive the queue.
+  ///
+  explicit safe_queue(std::pmr::memory_resource* resource)
+    : queue_{resource} {
+  }
+
   safe_queue(safe_queue& other) noexcept      = delete;
   safe_queue& operator=(safe_queue&) noexcept = delete;
 
@@ -57,9 +77,7 @@ public:
   /// \returns The current queue length.
   ///
   [[nodiscard]] std::size_t size() const {
-    std::shared_lock lock{mutex_};
-
-    return queue_.size();
+    return size_.load(std::memory_order_relaxed);
   }
 
   ///
@@ -68,9 +86,7 @@ public:
   /// \returns `true` if the queue is empty, `false` if otherwise.
   ///
   [[nodiscard]] bool empty() const {
-    std::shared_lock lock{mutex_};
-
-    return queue_.empty();
+    return (size() == 0);
   }
 
   ///
@@ -90,6 +106,7 @@ public:
     }
 
     queue_.push_back(std::forward<U>(element));
+    size_.store(queue_.size(), std::memory_order_relaxed);
 
     return true;
   }
@@ -109,6 +126,28 @@ public:
 
     result = std::move(queue_.front());
     queue_.pop_front();
+    size_.store(queue_.size(), std::memory_order_relaxed);
+
+    return result;
+  }
+
+  ///
+  /// Pop a number of elements off the front of the queue.
+  ///
+  /// \param count The maximum number of elements to pop.
+  ///
+  /// \returns The popped elements, in queue order. Holds less than `count` elements if the queue held less.
+  ///
+  [[nodiscard]] std::vector<T> pop_bulk(std::size_t count) {
+    std::unique_lock lock{mutex_};
+    std::vector<T>   result;
+
+    const auto last{queue_.begin() + static_cast<std::ptrdiff_t>(std::min(count, queue_.size()))};
+
+    result.reserve(static_cast<std::size_t>(last - queue_.begin()));
+    std::move(queue_.begin(), last, std::back_inserter(result));
+    queue_.erase(queue_.begin(), last);
+    size_.store(queue_.size(), std::memory_order_relaxed);
 
     return result;
   }
@@ -116,9 +155,16 @@ public:
   ///
   /// Flush the queue, removing all elements.
   ///
-  void flush() {
+  /// \returns The number of elements removed.
+  ///
+  std::size_t flush() {
     std::unique_lock lock{mutex_};
+    const auto size{queue_.size()};
+
     queue_.clear();
+    size_.store(0, std::memory_order_relaxed);
+
+    return size;
   }
 };
 
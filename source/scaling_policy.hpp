@@ -0,0 +1,30 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+
+namespace ts {
+
+inline namespace v1 {
+
+///
+/// Executor pool auto-scaling policy.
+///
+/// The number of executors is evaluated every `interval`. When the backlog (the number of queued jobs) exceeds
+///  `backlog_per_executor` for every executor, the queueing delay is rising and an executor is added. When executors
+///  have been idle without any backlog for `cool_down`, an executor is retired. The number of executors is kept within
+///  `min_executors..max_executors`.
+///
+struct scaling_policy {
+  std::size_t               min_executors{1};
+  std::size_t               max_executors{std::max(1u, std::thread::hardware_concurrency())};
+  std::size_t               backlog_per_executor{4};
+  std::chrono::milliseconds interval{10};
+  std::chrono::milliseconds cool_down{500};
+};
+
+} // namespace v1
+
+} // namespace ts
@@ -1,26 +1,66 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <exception>
 #include <functional>
+#include <iterator>
 #include <latch>
+#include <list>
 #include <memory>
+#include <memory_resource>
 #include <mutex>
 #include <optional>
 #include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <string_view>
 #include <thread>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 #include "completion_token.hpp"
+#include "deadline_queue.hpp"
+#include "executor_context.hpp"
+#include "executor_interface.hpp"
+#include "injection_queue.hpp"
+#include "metrics.hpp"
+#include "mpsc_queue.hpp"
 #include "multiqueue.hpp"
+#include "partition_policy.hpp"
+#include "pool_resource.hpp"
+#include "scaling_policy.hpp"
 #include "task.hpp"
+#include "topology.hpp"
+#include "tracing.hpp"
 
 namespace ts {
 
 inline namespace v1 {
 
+///
+/// Policy for tasks that are picked up for execution after their deadline has passed.
+///
+enum class expiry_policy {
+  run, ///< Run the task anyway.
+  drop ///< Skip the task: it completes without running, in the cancelled state.
+};
+
+///
+/// Type of the executor queues.
+///
+enum class queue_mode {
+  locked,   ///< Locked queues, storing the jobs in a container.
+  intrusive ///< Intrusive lock-free queues of pooled job nodes (see `mpsc_queue`).
+};
+
 ///
 /// Simple task scheduler.
 ///
@@ -28,49 +68,1089 @@ inline namespace v1 {
 ///  tasks with signature 'void()`, so it can be used to schedule tasks wrapped in a lambda expression. A multiqueue
 ///  is used to implement work stealing for executors: when their respective work queue is empty, work is taken from
 ///  another executors' queue. At schedule time, a completion token is returned for the callee to wait on task comple-
-///  tion.
+///  tion. When a task waits on a completion token, its executor keeps processing pending jobs in the meantime, so
+///  tasks can safely schedule and wait on child tasks (fork-join). From within a task, subtasks can be spawned onto
+///  the queue of the running executor using `this_executor::spawn`.
+///
+/// A task scheduled or spawned from within a task is put in the LIFO slot of the executor, so it runs next on the same
+///  executor while the data it consumes is still in the cache (see `enable_lifo_slot`). If the executor does not take
+///  it within a short delay, e.g. because the scheduling task blocks waiting for it, an idle executor steals it.
+///
+/// Tasks working on the same data can be kept on the same executor using `schedule_on` or `schedule_keyed` (soft
+///  affinity), still allowing them to be stolen by idle executors.
+///
+/// Every executor has a context, holding its index, an arena for temporary allocations that is reset after every
+///  task, and a cache of scratch objects. Tasks can access it using `this_executor::context`, or take it as argument.
+///
+/// The queue storage and job records can be allocated from a memory resource (e.g. a `pool_resource`) passed at
+///  construction. Tasks can allocate their callable from a memory resource as well, see `task`.
 ///
-/// The template argument `MaxQueueLength` indicates the maximum underlying task queue length.
+/// Tenants can be isolated from each other by scheduling their tasks in named partitions, which share the executors
+///  by weight, optionally restricted to a subset of the executors (see `create_partition`).
 ///
-template<unsigned int MaxQueueLength>
+/// A function can be launched for a range of indices using `schedule_n`, which shares a single function object and
+///  completion token for all indices.
+///
+/// Fire-and-forget tasks can be scheduled without completion token using `schedule_detached`, in which case errors
+///  are reported to a scheduler-wide exception handler. Use `wait_idle` to wait for all scheduled tasks to complete.
+///
+/// Tasks scheduled from outside the executors are submitted to a global (unbounded) injection queue, which the exec-
+///  utors poll periodically, and whenever their own queue is empty. When the queue of an executor is full, half of its
+///  jobs are moved to the injection queue. This way, bursts of work are absorbed without failing to schedule, while
+///  the executor queues stay local.
+///
+/// Scheduled tasks can be cancelled using their completion token. Cancelled tasks that have not started yet are
+///  skipped, while running tasks can observe cancellation through a stop token (see `schedule`).
+///
+/// When compiled with `TS_ENABLE_METRICS`, every executor keeps runtime metrics counters (see `metrics`). When
+///  compiled with `TS_ENABLE_TRACING`, the task lifecycle can be traced (see `tracing::start`).
+///
+/// Executors can optionally be pinned to CPUs and grouped by NUMA node using an executor placement, in which case
+///  executors prefer to steal work from executors on the same node.
+///
+/// Tasks that block (e.g. on I/O or a lock) can mark the blocking call using a `blocking_region`, in which case a
+///  compensating thread processes the work of the blocked executor until the blocking call returns.
+///
+/// Tasks can optionally be scheduled with a deadline, in which case they are processed in earliest-deadline-first
+///  order, before any tasks without a deadline (see `schedule`).
+///
+/// The number of executors can be changed at runtime using `resize`, or automatically based on the load using an
+///  auto-scaling policy (see `enable_auto_scaling`). Work queued for retired executors is moved to the remaining ones.
+///
+/// The template argument `MaxQueueLength` indicates the maximum length of the queues per executor. The template argu-
+///  ment `QueueMode` selects the type of these queues. With intrusive queues, scheduling a job takes no lock: the job
+///  is linked into the executor queue using a single atomic exchange, in a node taken from a pool that is owned by
+///  the scheduler. Executors consume their own queue, while stealing executors skip queues that are in use.
+///
+template<unsigned int MaxQueueLength, queue_mode QueueMode = queue_mode::locked>
 requires(MaxQueueLength < 8192) class simple_scheduler final {
   struct simple_job {
-    task<void()>                             task_;
-    std::shared_ptr<detail::completion_data> completion_;
+    task<void()>                                    task_;
+    std::shared_ptr<detail::completion_data>        completion_;
+    std::uint64_t                                   trace_id_;
+    [[no_unique_address]] detail::metrics_timestamp scheduled_at_;
+  };
+
+  struct deadline_job {
+    simple_job    job_;
+    expiry_policy expiry_;
+  };
+
+  struct stoppable_task {
+    task<void(std::stop_token)> task_;
+    std::stop_token             stop_token_;
+
+    void operator()() {
+      task_(stop_token_);
+    }
+  };
+
+  // Task adapter passing the context of the running executor.
+  struct contextual_task {
+    task<void(executor_context&)> task_;
+
+    void operator()() {
+      task_(detail::current_executor()->context());
+    }
+  };
+
+  // Shared state of a bulk launch: the function is stored once, and the worker jobs claim chunks of indices through an
+  //  atomic counter. The worker finishing the last chunk signals completion.
+  struct bulk_state {
+    task<void(std::size_t)>                           function_;
+    std::size_t                                       count_;
+    std::size_t                                       chunk_size_;
+    std::shared_ptr<detail::completion_data>          completion_;
+    std::atomic<bool>                                 failed_{};
+    std::atomic<bool>                                 cancelled_{};
+    alignas(cache_line_size) std::atomic<std::size_t> next_{};
+    alignas(cache_line_size) std::atomic<std::size_t> remaining_;
+
+    bulk_state(task<void(std::size_t)>&& function, std::size_t count, std::size_t chunk_size,
+               std::shared_ptr<detail::completion_data> completion)
+      : function_{std::move(function)}
+      , count_{count}
+      , chunk_size_{chunk_size}
+      , completion_{std::move(completion)}
+      , remaining_{count} {
+    }
+
+    void operator()() {
+      std::size_t finished{}; // Counted locally, so the shared counter is only updated once per job.
+
+      for (auto first{next_.fetch_add(chunk_size_, std::memory_order_relaxed)}; first < count_;
+           first = next_.fetch_add(chunk_size_, std::memory_order_relaxed)) {
+        const auto last{std::min(first + chunk_size_, count_)};
+
+        // After cancellation or failure, the remaining chunks are claimed but skipped.
+        if (completion_->stop_requested()) {
+          cancelled_.store(true, std::memory_order_relaxed);
+        } else if (!failed_.load(std::memory_order_relaxed)) {
+          try {
+            for (auto index{first}; index < last; index++) {
+              function_(index);
+            }
+          } catch (...) {
+            if (!failed_.exchange(true, std::memory_order_relaxed)) {
+              completion_->exception() = std::current_exception();
+            }
+          }
+        }
+
+        finished += last - first;
+      }
+
+      if (finished > 0) {
+        finish(finished); // A job that claimed no chunk must not complete the range again.
+      }
+    }
+
+    void finish(std::size_t count) {
+      if (remaining_.fetch_sub(count, std::memory_order_acq_rel) != count) {
+        return;
+      }
+
+      if (cancelled_.load(std::memory_order_relaxed)) {
+        completion_->trigger_cancellation();
+      } else {
+        completion_->trigger_completion();
+      }
+    }
+  };
+
+  // A named partition, with its own queue. The executors restriction is empty if the partition is unrestricted.
+  struct partition_state {
+    std::string                 name_;
+    unsigned int                weight_;
+    std::vector<bool>           executors_;
+    injection_queue<simple_job> queue_;
+
+    partition_state(std::string name, unsigned int weight, std::vector<bool> executors,
+                    std::pmr::memory_resource* resource)
+      : name_{std::move(name)}
+      , weight_{weight}
+      , executors_{std::move(executors)}
+      , queue_{resource} {
+    }
+
+    [[nodiscard]] bool allows(unsigned int id) const noexcept {
+      return executors_.empty() || executors_[id];
+    }
+  };
+
+  // Deficit round-robin state of an executor: the number of jobs left per slot in the current round, and the slot
+  //  taking its turn. Slot 0 holds the jobs outside of any partition, slot `i + 1` holds partition `i`.
+  struct fair_share {
+    std::vector<unsigned int> deficits_;
+    std::size_t               slot_{};
+  };
+
+  struct compensator {
+    std::atomic<bool> finished_{};
+    std::jthread      thread_;
+  };
+
+  using compensators = std::list<compensator>;
+
+  // Scope of a job placement on a specific executor queue. The number of executors is read once on entry. A shrinking
+  //  `resize` waits for the placements in progress before moving the work off the retired queues, so the selected
+  //  queue stays live until the job is queued.
+  class placement_scope final {
+    std::atomic<std::size_t>& placements_;
+    std::size_t               num_executors_;
+
+  public:
+    placement_scope(std::atomic<std::size_t>& placements, const std::atomic<std::size_t>& num_executors) noexcept
+      : placements_{placements} {
+      // Ordered with the store of the executor count in `resize`: either this sees the new count, or the placement
+      //  is seen in progress.
+      placements_.fetch_add(1, std::memory_order_seq_cst);
+      num_executors_ = num_executors.load(std::memory_order_seq_cst);
+    }
+
+    placement_scope(const placement_scope&)            = delete;
+    placement_scope& operator=(const placement_scope&) = delete;
+
+    ~placement_scope() {
+      placements_.fetch_sub(1, std::memory_order_release);
+    }
+
+    [[nodiscard]] std::size_t num_executors() const noexcept {
+      return num_executors_;
+    }
+  };
+
+  class executor_state final : public detail::executor_interface {
+    simple_scheduler&                            scheduler_;
+    unsigned int                                 id_;
+    unsigned int                                 ticks_{};
+    std::mutex                                   lifo_mutex_;
+    std::optional<simple_job>                    lifo_job_;        // Guarded by `lifo_mutex_`, as it may be stolen.
+    std::atomic<std::uint64_t>                   lifo_sequence_{}; // Odd while the slot holds a job.
+    unsigned int                                 lifo_streak_{};
+    unsigned int                                 depth_{};
+    fair_share                                   fair_share_;
+    executor_context                             context_;
+    detail::executor_interface*                  previous_;
+    std::vector<typename compensators::iterator> compensators_;
+
+    // Only called with `lifo_mutex_` held.
+    void advance_lifo_sequence(std::uint64_t count) noexcept {
+      lifo_sequence_.store(lifo_sequence() + count, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] std::optional<simple_job> remove_lifo_job() {
+      if ((lifo_sequence() % 2) == 0) {
+        return {}; // Only this executor fills the slot, so it is empty without taking the lock.
+      }
+
+      std::unique_lock lock{lifo_mutex_};
+
+      if (!lifo_job_) {
+        return {}; // Stolen concurrently.
+      }
+
+      advance_lifo_sequence(1);
+      return std::exchange(lifo_job_, std::nullopt);
+    }
+
+  public:
+    executor_state(simple_scheduler& scheduler, unsigned int id)
+      : scheduler_{scheduler}
+      , id_{id}
+      , context_{id}
+      , previous_{std::exchange(detail::current_executor(), this)} {
+      scheduler_.add_executor_state(*this);
+    }
+
+    ~executor_state() override {
+      scheduler_.remove_executor_state(*this);
+      detail::current_executor() = previous_;
+    }
+
+    executor_state(const executor_state&)            = delete;
+    executor_state& operator=(const executor_state&) = delete;
+
+    [[nodiscard]] bool belongs_to(const simple_scheduler& scheduler) const noexcept {
+      return (&scheduler_ == &scheduler);
+    }
+
+    [[nodiscard]] unsigned int id() const noexcept {
+      return id_;
+    }
+
+    [[nodiscard]] unsigned int next_tick() noexcept {
+      return ticks_++;
+    }
+
+    [[nodiscard]] fair_share& fair_share_state() noexcept {
+      return fair_share_;
+    }
+
+    [[nodiscard]] std::optional<simple_job> exchange_lifo_job(simple_job&& job) {
+      std::unique_lock lock{lifo_mutex_};
+      auto             displaced{std::exchange(lifo_job_, std::move(job))};
+
+      advance_lifo_sequence(displaced ? 2 : 1); // A new job is in the slot.
+
+      return displaced;
+    }
+
+    [[nodiscard]] std::optional<simple_job> take_lifo_job() {
+      if (lifo_streak_ >= MAX_LIFO_STREAK) {
+        // Starvation guard: move the job to the back of the local queue, so the queued jobs get a turn.
+        lifo_streak_ = 0;
+        release_lifo_job();
+        return {};
+      }
+
+      auto job{remove_lifo_job()};
+      lifo_streak_ = job ? (lifo_streak_ + 1) : 0;
+
+      return job;
+    }
+
+    void release_lifo_job() {
+      if (auto job{remove_lifo_job()}) {
+        scheduler_.push_local(id_, std::move(*job));
+        scheduler_.notify_idle_executor();
+      }
+    }
+
+    [[nodiscard]] std::uint64_t lifo_sequence() const noexcept {
+      return lifo_sequence_.load(std::memory_order_relaxed);
+    }
+
+    // Take the job from the slot for another executor, if it is still the job that was seen at the given sequence.
+    [[nodiscard]] std::optional<simple_job> steal_lifo_job(std::uint64_t sequence) {
+      std::unique_lock lock{lifo_mutex_};
+
+      if (((sequence % 2) == 0) || (lifo_sequence() != sequence)) {
+        return {};
+      }
+
+      advance_lifo_sequence(1);
+      return std::exchange(lifo_job_, std::nullopt);
+    }
+
+    [[nodiscard]] bool run_pending_job() override {
+      // Jobs may run nested, while a job waits on a completion token: only reset the arena when the outermost is done.
+      depth_++;
+      const auto result{scheduler_.run_pending_job(*this)};
+
+      if (--depth_ == 0) {
+        context_.reset_arena();
+      }
+
+      return result;
+    }
+
+    [[nodiscard]] bool spawn(task<void()>&& task, std::shared_ptr<detail::completion_data> completion) override {
+      return scheduler_.spawn(*this, std::move(task), std::move(completion));
+    }
+
+    void begin_blocking() override {
+      release_lifo_job(); // Leave the job to the compensating thread.
+      compensators_.push_back(scheduler_.start_compensator(id_));
+    }
+
+    void end_blocking() override {
+      scheduler_.stop_compensator(compensators_.back());
+      compensators_.pop_back();
+    }
+
+    [[nodiscard]] executor_context& context() noexcept override {
+      return context_;
+    }
+
+    [[nodiscard]] std::pmr::memory_resource* resource() const noexcept override {
+      return scheduler_.resource_;
+    }
   };
 
-  std::size_t                            num_executors_;
-  multiqueue<simple_job, MaxQueueLength> queue_;
-  std::vector<std::jthread>              executors_;
-  std::latch                             executors_started_;
-  std::mutex                             work_mutex_;
-  std::condition_variable                work_cv_;
+  using job_queue_t      = std::conditional_t<(QueueMode == queue_mode::intrusive),
+                                           mpsc_queue<simple_job, MaxQueueLength>,
+                                           safe_queue<simple_job, MaxQueueLength>>;
+  using queue_t          = multiqueue<simple_job, MaxQueueLength, job_queue_t>;
+  using deadline_queue_t = deadline_queue<deadline_job, MaxQueueLength>;
+
+  static constexpr unsigned int INJECTION_POLL_INTERVAL{61};
+  static constexpr unsigned int MAX_LIFO_STREAK{3};
+  static constexpr std::size_t  BULK_CHUNKS_PER_EXECUTOR{4};
+  static constexpr std::size_t  MAX_PARTITIONS{64};
+  static constexpr std::size_t  SPILL_COUNT{(MaxQueueLength + 1) / 2};
+
+  static constexpr std::chrono::microseconds LIFO_STEAL_DELAY{20};
+
+  std::atomic<std::size_t>                                     num_executors_{};
+  std::atomic<std::size_t>                                     placements_in_progress_{};
+  executor_placement                                           placement_;
+  std::pmr::memory_resource*                                   resource_;
+  std::unique_ptr<pool_resource>                               job_pool_;
+  queue_t                                                      queue_;
+  injection_queue<simple_job>                                  injection_;
+  std::deque<deadline_queue_t>                                 deadline_queues_;
+  alignas(cache_line_size) std::atomic<std::size_t>            deadline_cursor_{};
+  alignas(cache_line_size) std::atomic<std::ptrdiff_t>         deadline_occupancy_{};
+  std::array<std::unique_ptr<partition_state>, MAX_PARTITIONS> partitions_;
+  std::atomic<std::size_t>                                     num_partitions_{};
+  std::mutex                                                   partitions_mutex_;
+  std::deque<detail::executor_counters>                        counters_;
+  std::vector<std::jthread>                                    executors_;
+  std::vector<executor_state*>                                 executor_states_;
+  std::mutex                                                   executor_states_mutex_;
+  compensators                                                 compensators_;
+  bool                                                         compensators_stopped_{}; // Set when shutting down.
+  std::mutex                                                   compensators_mutex_;
+  std::mutex                                                   resize_mutex_;
+  std::mutex                                                   work_mutex_;
+  std::condition_variable                                      work_cv_;
+  std::atomic<std::size_t>                                     num_idle_executors_{};
+  std::atomic<bool>                                            lifo_slot_enabled_{true};
+  alignas(cache_line_size) std::atomic<std::size_t>            in_flight_{};
+  std::mutex                                                   exception_handler_mutex_;
+  std::function<void(std::exception_ptr)>                      exception_handler_;
+  alignas(cache_line_size) std::atomic<std::uint64_t>          schedule_rejections_{};
+  std::jthread                                                 scaler_;
+
+  [[nodiscard]] executor_state* local_executor() const noexcept {
+    auto* state{dynamic_cast<executor_state*>(detail::current_executor())};
+    return ((state != nullptr) && state->belongs_to(*this)) ? state : nullptr;
+  }
+
+  template<typename... Args>
+  [[nodiscard]] std::shared_ptr<detail::completion_data> make_completion(Args&&... args) const {
+    return std::allocate_shared<detail::completion_data>(
+      std::pmr::polymorphic_allocator<detail::completion_data>{resource_}, std::forward<Args>(args)...);
+  }
+
+  template<typename T>
+  [[nodiscard]] task<void()> make_task(T&& callable) const {
+    return task<void()>{std::allocator_arg, resource_, std::forward<T>(callable)};
+  }
+
+  [[nodiscard]] simple_job make_job(task<void()>&& task, std::shared_ptr<detail::completion_data> completion) {
+    auto job{simple_job{std::move(task), std::move(completion), detail::trace_job_id(), detail::metrics_now()}};
+
+    in_flight_.fetch_add(1, std::memory_order_relaxed);
+    detail::trace(detail::trace_event_type::scheduled, job.trace_id_);
+
+    return job;
+  }
+
+  void finish_jobs(std::size_t count) {
+    if ((count > 0) && (in_flight_.fetch_sub(count, std::memory_order_acq_rel) == count)) {
+      in_flight_.notify_all();
+    }
+  }
+
+  void schedule_job(task<void()>&& task, std::shared_ptr<detail::completion_data> completion) {
+    auto job{make_job(std::move(task), std::move(completion))};
+
+    if (auto* state{local_executor()}; state != nullptr) {
+      std::optional<simple_job> displaced{std::move(job)};
+
+      if (lifo_slot_enabled_.load(std::memory_order_relaxed)) {
+        displaced = state->exchange_lifo_job(std::move(*displaced));
+      }
+
+      // From within an executor: the job runs next on this executor (LIFO slot), while the job it displaces uses the
+      //  regular load distribution, falling back to the local queue if the queues are full.
+      if (displaced) {
+        if (!queue_.push(std::move(*displaced))) {
+          push_local(state->id(), std::move(*displaced));
+        }
+      }
+
+      notify_idle_executor(); // A job in the LIFO slot can be stolen as well, see `steal_lifo_job`.
+      return;
+    }
+
+    injection_.push(std::move(job));
+    notify_idle_executor();
+  }
+
+  void push_local(unsigned int id, simple_job&& job) {
+    if (queue_.push(id, std::move(job))) {
+      return;
+    }
+
+    // The local queue is full: move half of it to the injection queue, instead of rejecting the job.
+    injection_.push_bulk(queue_.pop_bulk(id, SPILL_COUNT));
+
+    if (!queue_.push(id, std::move(job))) {
+      injection_.push(std::move(job)); // Filled up again concurrently.
+    }
+  }
+
+  // Must be called within a `placement_scope`, with an index below its number of executors.
+  void schedule_job_on(std::size_t index, task<void()>&& task, std::shared_ptr<detail::completion_data> completion) {
+    push_local(static_cast<unsigned int>(index), make_job(std::move(task), std::move(completion)));
+
+    if (auto* state{local_executor()}; (state == nullptr) || (state->id() != index)) {
+      notify_idle_executor();
+    }
+  }
+
+  void notify_idle_executor(bool all = false) {
+    // Only involve the condition variable if some executor is idle and able to steal the work. This is a read-modify-
+    //  write, ordered with the increment in `park`: either the parking executor sees the new work, or it is seen idle.
+    if (num_idle_executors_.fetch_add(0, std::memory_order_acq_rel) == 0) {
+      return;
+    }
+
+    // Synchronize with the parking executor, so it is waiting on the condition variable when notified.
+    std::unique_lock lock{work_mutex_};
+
+    if (all) {
+      work_cv_.notify_all();
+    } else {
+      work_cv_.notify_one();
+    }
+  }
+
+  [[nodiscard]] bool push_deadline_job(std::chrono::steady_clock::time_point deadline, deadline_job&& job) {
+    const auto num_active_queues{num_executors()};
+
+    for (std::size_t advance_count{}; advance_count < num_active_queues; advance_count++) {
+      const auto sink{deadline_cursor_.fetch_add(1, std::memory_order_relaxed) % num_active_queues};
+
+      if (deadline_queues_[sink].push(deadline, std::move(job))) {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  [[nodiscard]] bool schedule_deadline_job(task<void()>&& task, std::shared_ptr<detail::completion_data> completion,
+                                           std::chrono::steady_clock::time_point deadline, expiry_policy expiry) {
+    auto job{deadline_job{make_job(std::move(task), std::move(completion)), expiry}};
+
+    if (push_deadline_job(deadline, std::move(job))) {
+      deadline_occupancy_.fetch_add(1, std::memory_order_relaxed);
+      notify_idle_executor();
+      return true;
+    }
+
+    task = std::move(job.job_.task_); // Hand back the task in case scheduling failed.
+    count_rejection();
+    detail::trace(detail::trace_event_type::rejected, job.job_.trace_id_);
+    finish_jobs(1);
+
+    return false;
+  }
+
+  [[nodiscard]] std::optional<simple_job> pop_deadline_job(unsigned int id, bool& stolen) {
+    if (deadline_occupancy_.load(std::memory_order_relaxed) <= 0) {
+      return {}; // Keeps the cost for schedulers without deadline tasks at a single atomic load.
+    }
+
+    // Take the earliest deadline of the local queue. If it is empty, steal the earliest deadline of all queues.
+    auto source{static_cast<std::size_t>(id)};
+
+    if (deadline_queues_[id].empty()) {
+      std::optional<std::chrono::steady_clock::time_point> earliest;
+
+      for (std::size_t i{}; i < deadline_queues_.size(); i++) {
+        if (const auto candidate{deadline_queues_[i].earliest_deadline()};
+            candidate && (!earliest || (*candidate < *earliest))) {
+          earliest = candidate;
+          source   = i;
+        }
+      }
+    }
+
+    std::chrono::steady_clock::time_point deadline;
+    auto                                  job{deadline_queues_[source].pop(deadline)};
+
+    if (!job) {
+      return {};
+    }
+
+    deadline_occupancy_.fetch_sub(1, std::memory_order_relaxed);
+    stolen = (source != id);
+
+    if (std::chrono::steady_clock::now() > deadline) {
+      if constexpr (metrics_enabled) {
+        counters_[id].count_deadline_miss();
+      }
+
+      if (job->expiry_ == expiry_policy::drop) {
+        job->job_.completion_->request_stop(); // Skipped as a cancelled job.
+      }
+    }
+
+    return std::move(job->job_);
+  }
+
+  [[nodiscard]] std::optional<simple_job> pop_injected_job(unsigned int id) {
+    // Take a fair share of the injected jobs at once, to amortize polling the injection queue.
+    const auto count{std::clamp(injection_.size() / std::max(num_executors(), std::size_t{1}), std::size_t{1},
+                                SPILL_COUNT)};
+    auto       batch{injection_.pop_bulk(count)};
+
+    if (batch.empty()) {
+      return {};
+    }
+
+    // Keep the rest of the batch in the local queue, where it can still be stolen by other executors.
+    for (auto i{std::next(batch.begin())}; i != batch.end(); i++) {
+      if (!queue_.push(id, std::move(*i))) {
+        injection_.push(std::move(*i));
+      }
+    }
+
+    return std::move(batch.front());
+  }
+
+  [[nodiscard]] std::optional<simple_job> pop_job(unsigned int id, unsigned int tick, bool& stolen) {
+    // Poll the injection queue periodically, so injected jobs are not starved by a busy local queue.
+    if ((tick % INJECTION_POLL_INTERVAL) == 0) {
+      if (auto job{injection_.pop()}; job.has_value()) {
+        return job;
+      }
+    }
+
+    if (auto job{queue_.pop_local(id)}; job.has_value()) {
+      return job;
+    }
+
+    if (auto job{pop_injected_job(id)}; job.has_value()) {
+      return job;
+    }
+
+    return queue_.pop(id, stolen);
+  }
+
+  [[nodiscard]] std::optional<simple_job> pop_partition_job(unsigned int id, std::size_t index) {
+    auto& partition{*partitions_[index]};
+    return partition.allows(id) ? partition.queue_.pop() : std::nullopt;
+  }
+
+  [[nodiscard]] std::optional<simple_job> pop_fair_job(executor_state& state, bool& stolen) {
+    const auto id{state.id()};
+    const auto num_partitions{num_partitions_.load(std::memory_order_acquire)};
+
+    if (num_partitions == 0) {
+      return pop_job(id, state.next_tick(), stolen);
+    }
+
+    // Weighted deficit round-robin, at a cost of one per job: a slot with work gets a turn of `weight` jobs, a slot
+    //  without work (for this executor) forfeits its turn, so idle capacity flows to the slots that do have work.
+    auto&      share{state.fair_share_state()};
+    const auto num_slots{num_partitions + 1};
+
+    share.deficits_.resize(num_slots);
+
+    for (std::size_t visited{}; visited < num_slots; visited++) {
+      const auto slot{share.slot_ % num_slots};
+      auto&      deficit{share.deficits_[slot]};
+
+      if (deficit == 0) {
+        deficit = (slot == 0) ? 1 : partitions_[slot - 1]->weight_;
+      }
+
+      auto job{(slot == 0) ? pop_job(id, state.next_tick(), stolen) : pop_partition_job(id, slot - 1)};
+
+      if (job && (--deficit > 0)) {
+        return job;
+      }
+
+      deficit     = 0;
+      share.slot_ = slot + 1;
+
+      if (job) {
+        return job;
+      }
+    }
+
+    return {};
+  }
+
+  // The backlog of all queues. If an executor id is given, only the partitions the executor may run are included.
+  [[nodiscard]] std::size_t approximate_backlog(std::optional<unsigned int> id = {}) const noexcept {
+    const auto deadline_backlog{std::max(deadline_occupancy_.load(std::memory_order_relaxed), std::ptrdiff_t{})};
+    auto       result{queue_.approximate_size() + injection_.size() + static_cast<std::size_t>(deadline_backlog)};
+
+    for (std::size_t i{}; i < num_partitions_.load(std::memory_order_acquire); i++) {
+      if (!id || partitions_[i]->allows(*id)) {
+        result += partitions_[i]->queue_.size();
+      }
+    }
+
+    return result;
+  }
+
+  void count_rejection() noexcept {
+    if constexpr (metrics_enabled) {
+      schedule_rejections_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  void run_job(simple_job& job) {
+    // Detached jobs have no completion data, so they cannot be cancelled, and report exceptions to the handler.
+    if (!job.completion_) {
+      detail::trace(detail::trace_event_type::started, job.trace_id_);
+
+      try {
+        job.task_();
+      } catch (...) {
+        handle_exception(std::current_exception());
+      }
+
+      detail::trace(detail::trace_event_type::finished, job.trace_id_);
+      return;
+    }
+
+    // Cancelled jobs are skipped. The cancellation request is a single flag, so no queue scan is needed.
+    if (job.completion_->stop_requested()) {
+      detail::trace(detail::trace_event_type::cancelled, job.trace_id_);
+      job.completion_->trigger_cancellation();
+      return;
+    }
+
+    detail::trace(detail::trace_event_type::started, job.trace_id_);
+
+    try {
+      job.task_();
+    } catch (...) {
+      job.completion_->exception() = std::current_exception();
+    }
+
+    detail::trace(detail::trace_event_type::finished, job.trace_id_);
+
+    job.completion_->trigger_completion();
+  }
+
+  void handle_exception(std::exception_ptr error) {
+    std::function<void(std::exception_ptr)> handler;
+
+    {
+      std::unique_lock lock{exception_handler_mutex_};
+      handler = exception_handler_;
+    }
+
+    if (handler) {
+      try {
+        handler(std::move(error));
+      } catch (...) {
+        // An exception escaping the handler cannot be reported anywhere: it is discarded.
+      }
+    }
+  }
+
+  [[nodiscard]] bool run_pending_job(executor_state& state) {
+    const auto id{state.id()};
+    bool       stolen{};
+    auto       job{pop_deadline_job(id, stolen)};
+
+    if (!job) {
+      job = state.take_lifo_job();
+    }
+
+    if (!job) {
+      job = pop_fair_job(state, stolen);
+    }
+
+    if (!job) {
+      job    = steal_lifo_job(state);
+      stolen = job.has_value();
+    }
+
+    if constexpr (metrics_enabled) {
+      counters_[id].count_pop(job.has_value(), stolen);
+    }
+
+    if (!job) {
+      return false;
+    }
+
+    detail::trace(stolen ? detail::trace_event_type::dequeued_stolen : detail::trace_event_type::dequeued_local,
+                  job->trace_id_);
+
+    if constexpr (metrics_enabled) {
+      const auto start{std::chrono::steady_clock::now()};
+      counters_[id].count_queue_delay(start - job->scheduled_at_);
+
+      run_job(*job);
+
+      counters_[id].count_execution_time(std::chrono::steady_clock::now() - start);
+      counters_[id].count_task();
+    } else {
+      run_job(*job);
+    }
+
+    job.reset(); // Release the task before signalling, so no captured state outlives `wait_idle`.
+    finish_jobs(1);
+
+    return true;
+  }
+
+  [[nodiscard]] bool spawn(executor_state& state, task<void()>&& task,
+                           std::shared_ptr<detail::completion_data> completion) {
+    std::optional<simple_job> displaced{make_job(std::move(task), std::move(completion))};
+
+    if (lifo_slot_enabled_.load(std::memory_order_relaxed)) {
+      displaced = state.exchange_lifo_job(std::move(*displaced));
+    }
+
+    if (displaced) {
+      push_local(state.id(), std::move(*displaced));
+    }
+
+    notify_idle_executor(); // A job in the LIFO slot can be stolen as well, see `steal_lifo_job`.
+    return true;
+  }
+
+  [[nodiscard]] bool process(executor_state& state, unsigned int id) {
+    if constexpr (metrics_enabled) {
+      const auto start{std::chrono::steady_clock::now()};
+
+      if (state.run_pending_job()) {
+        counters_[id].count_busy(std::chrono::steady_clock::now() - start);
+        return true;
+      }
+
+      return false;
+    } else {
+      return state.run_pending_job();
+    }
+  }
+
+  void add_executor_state(executor_state& state) {
+    std::unique_lock lock{executor_states_mutex_};
+    executor_states_.push_back(&state);
+  }
+
+  void remove_executor_state(executor_state& state) {
+    std::unique_lock lock{executor_states_mutex_};
+    std::erase(executor_states_, &state);
+  }
+
+  // Find a job in the LIFO slot of another executor. Returns the executor and the sequence of its slot.
+  [[nodiscard]] std::pair<executor_state*, std::uint64_t> find_lifo_job(const executor_state& thief) {
+    std::unique_lock lock{executor_states_mutex_};
+
+    for (auto* state : executor_states_) {
+      if (const auto sequence{state->lifo_sequence()}; (state != &thief) && ((sequence % 2) != 0)) {
+        return {state, sequence};
+      }
+    }
+
+    return {};
+  }
+
+  [[nodiscard]] std::optional<simple_job> steal_lifo_job(const executor_state& thief) {
+    // A job in the LIFO slot of another executor is only taken if that executor did not take it within a short delay,
+    //  e.g. because its task blocks waiting for the job. A slot that keeps changing is left alone, to keep locality.
+    const auto [victim, sequence]{find_lifo_job(thief)};
+
+    if (victim == nullptr) {
+      return {};
+    }
+
+    std::this_thread::sleep_for(LIFO_STEAL_DELAY);
+
+    std::unique_lock lock{executor_states_mutex_};
+
+    if (std::find(executor_states_.begin(), executor_states_.end(), victim) == executor_states_.end()) {
+      return {}; // The executor has stopped, releasing its slot.
+    }
+
+    return victim->steal_lifo_job(sequence);
+  }
+
+  void park(const std::stop_token& stop_token, const executor_state& state) {
+    const auto id{state.id()};
+    const auto has_work = [&] {
+      return (approximate_backlog(id) > 0) || (find_lifo_job(state).first != nullptr) || stop_token.stop_requested();
+    };
+
+    std::unique_lock lock{work_mutex_};
+
+    if (has_work()) {
+      return;
+    }
+
+    num_idle_executors_++; // Work is checked again before waiting, see `notify_idle_executor`.
+
+    if constexpr (metrics_enabled) {
+      counters_[id].count_park();
+
+      const auto start{std::chrono::steady_clock::now()};
+      work_cv_.wait(lock, has_work);
+      counters_[id].count_unpark(std::chrono::steady_clock::now() - start);
+    } else {
+      work_cv_.wait(lock, has_work);
+    }
+
+    num_idle_executors_--;
+  }
+
+  void executor(std::stop_token stop_token, unsigned int id, std::shared_ptr<std::latch> started) {
+    started->arrive_and_wait();
+
+    executor_state state{*this, id};
+    detail::trace_thread_name("executor " + std::to_string(id));
+
+    while (!stop_token.stop_requested()) {
+      if (!process(state, id)) {
+        park(stop_token, state);
+      }
+    }
+
+    state.release_lifo_job();
+  }
+
+  void compensate(std::stop_token stop_token, unsigned int id, compensator& self) {
+    {
+      executor_state state{*this, id};
+      detail::trace_thread_name("compensator " + std::to_string(id));
+
+      while (!stop_token.stop_requested()) {
+        if (!process(state, id)) {
+          park(stop_token, state);
+        }
+      }
+
+      state.release_lifo_job();
+    }
+
+    self.finished_.store(true, std::memory_order_release);
+  }
+
+  // Only called with `compensators_mutex_` held.
+  void remove_finished_compensators() {
+    compensators_.remove_if([](const compensator& c) { return c.finished_.load(std::memory_order_acquire); });
+  }
+
+  [[nodiscard]] typename compensators::iterator start_compensator(unsigned int id) {
+    std::unique_lock lock{compensators_mutex_};
+
+    if (compensators_stopped_) {
+      return compensators_.end(); // Shutting down: the blocked executor is not compensated.
+    }
+
+    remove_finished_compensators();
+
+    auto result{compensators_.emplace(compensators_.end())};
+    result->thread_ = std::jthread{std::bind_front(&simple_scheduler::compensate, this), id, std::ref(*result)};
+
+    return result;
+  }
+
+  void stop_compensator(typename compensators::iterator position) {
+    std::unique_lock lock{compensators_mutex_};
+
+    if (compensators_stopped_) {
+      return; // All compensators are stopped by `stop_compensators`.
+    }
+
+    {
+      std::unique_lock work_lock{work_mutex_};
+      position->thread_.request_stop();
+      work_cv_.notify_all();
+    }
+
+    remove_finished_compensators();
+  }
+
+  void stop_compensators() {
+    compensators stopped;
+
+    {
+      std::unique_lock lock{compensators_mutex_};
+      compensators_stopped_ = true;
+
+      {
+        std::unique_lock work_lock{work_mutex_};
+        std::ranges::for_each(compensators_, [](auto& c) { c.thread_.request_stop(); });
+        work_cv_.notify_all();
+      }
+
+      stopped.splice(stopped.end(), compensators_);
+    }
+
+    // Joined without holding the lock, as a compensator may still end a (nested) blocking region.
+    stopped.clear();
+  }
+
+  [[nodiscard]] static queue_t make_queue(std::size_t num_executors, const executor_placement& placement,
+                                          std::pmr::memory_resource* resource) {
+    if (placement.nodes.empty()) {
+      return queue_t{std::allocator_arg, resource, num_executors};
+    }
 
-  void executor(std::stop_token stop_token, unsigned int id) {
-    executors_started_.arrive_and_wait();
+    if (placement.nodes.size() != placement.cpus.size()) {
+      throw std::invalid_argument("Executor placement must specify a NUMA node for every CPU");
+    }
 
-    while (!stop_token.stop_requested()) {
-      if (auto&& job{queue_.pop(id)}; job) {
+    std::vector<unsigned int> groups(num_executors);
+    for (std::size_t i{}; i < num_executors; i++) {
+      groups[i] = placement.nodes[i % placement.nodes.size()];
+    }
+
+    return queue_t{std::allocator_arg, resource, num_executors, std::move(groups)};
+  }
+
+  void auto_scale(const std::stop_token& stop_token, const scaling_policy& policy) {
+    std::mutex                  mutex;
+    std::condition_variable_any cv;
+    std::unique_lock            lock{mutex};
+
+    auto idle_since{std::chrono::steady_clock::now()};
+
+    const auto stopped = [&] { return stop_token.stop_requested(); };
+
+    while (!cv.wait_for(lock, stop_token, policy.interval, stopped)) {
+      const auto current{num_executors()};
+      const auto backlog{approximate_backlog()};
+      const auto now{std::chrono::steady_clock::now()};
+
+      // The backlog per executor is used as a measure for the queueing delay (by Little's law).
+      auto target{std::clamp(current, policy.min_executors, policy.max_executors)};
+
+      if ((target == current) && (backlog > (policy.backlog_per_executor * current))) {
+        target = std::min(current + 1, policy.max_executors);
+      }
+
+      if ((backlog > 0) || (num_idle_executors_.load(std::memory_order_relaxed) == 0) || (target != current)) {
+        idle_since = now;
+      } else if ((current > policy.min_executors) && ((now - idle_since) >= policy.cool_down)) {
+        target     = current - 1;
+        idle_since = now;
+      }
+
+      if (target != current) {
         try {
-          (*job).task_();
+          resize(target);
         } catch (...) {
-          (*job).completion_->exception() = std::current_exception();
+          return; // Stop scaling if executors cannot be created (e.g. when pinning fails).
         }
+      }
+    }
+  }
 
-        (*job).completion_->trigger_completion();
-      } else {
-        std::unique_lock lock{work_mutex_};
-        work_cv_.wait(lock, [&] { return !queue_.empty() || stop_token.stop_requested(); });
+  void validate_num_executors(std::size_t num_executors) const {
+    if (num_executors == 0) {
+      throw std::underflow_error("At least one executor must be requested");
+    }
+
+    if (num_executors > max_executors()) {
+      throw std::overflow_error("Too many executors requested for hardware support");
+    }
+  }
+
+  void create_executors(std::size_t num_executors) {
+    const auto         first{executors_.size()};
+    auto               started{std::make_shared<std::latch>(static_cast<std::ptrdiff_t>(num_executors - first + 1))};
+    std::exception_ptr error;
+
+    for (auto i{static_cast<unsigned int>(first)}; i < static_cast<unsigned int>(num_executors); i++) {
+      auto& executor{executors_.emplace_back(std::bind_front(&simple_scheduler::executor, this), i, started)};
+
+      if (!placement_.cpus.empty() && !error) {
+        try {
+          detail::pin_thread(executor.native_handle(), placement_.cpus[i % placement_.cpus.size()]);
+        } catch (...) {
+          error = std::current_exception();
+        }
+      }
+    }
+
+    started->arrive_and_wait(); // +1 for the calling thread.
+
+    if (error) {
+      stop_executors(first);
+      std::rethrow_exception(error);
+    }
+
+    queue_.set_num_active_queues(num_executors);
+    num_executors_.store(num_executors, std::memory_order_relaxed);
+  }
+
+  void migrate_deadline_jobs(std::size_t index) {
+    std::chrono::steady_clock::time_point deadline;
+
+    while (auto job{deadline_queues_[index].pop(deadline)}) {
+      if (!push_deadline_job(deadline, std::move(*job))) {
+        // The active queues are full: put the job back, it remains available for stealing.
+        (void)deadline_queues_[index].push(deadline, std::move(*job));
+        break;
       }
     }
   }
 
-  void create_executors() {
-    for (unsigned int i{}; i < static_cast<unsigned int>(num_executors_); i++) {
-      executors_.emplace_back(std::bind_front(&simple_scheduler<MaxQueueLength>::executor, this), i);
+  void stop_executors(std::size_t first) {
+    {
+      std::unique_lock lock{work_mutex_};
+      std::for_each(executors_.begin() + static_cast<std::ptrdiff_t>(first), executors_.end(),
+                    [](auto& executor) { executor.request_stop(); });
+      work_cv_.notify_all();
     }
 
-    executors_started_.arrive_and_wait();
+    executors_.resize(first);
   }
 
 public:
@@ -83,69 +1163,534 @@ public:
   /// \throws `std::overflow_error` if the provided amount of executors is greater than the number of execution cores.
   ///
   explicit simple_scheduler(std::size_t num_executors)
-    : num_executors_{num_executors}
-    , queue_{num_executors}
-    , executors_started_{static_cast<std::ptrdiff_t>(num_executors + 1)} { // +1 for the main thread.
-    if (num_executors_ == 0) {
-      throw std::underflow_error("At least one executor must be requested");
-    }
+    : simple_scheduler{num_executors, executor_placement{}} {
+  }
 
-    if (num_executors_ > std::jthread::hardware_concurrency()) {
-      throw std::overflow_error("Too many executors requested for hardware support");
-    }
+  ///
+  /// Constructor.
+  ///
+  /// \param num_executors The number of task executors. Must be between 1 and the number of execution cores.
+  /// \param placement     The executor placement: the CPUs to pin the executors to, and optionally the NUMA node per
+  ///                      CPU (see `numa_placement`).
+  ///
+  /// \throws `std::underflow_error` if the provided amount of executors is 0.
+  /// \throws `std::overflow_error` if the provided amount of executors is greater than the number of execution cores.
+  /// \throws `std::invalid_argument` if the placement specifies NUMA nodes, but not for every CPU.
+  /// \throws `std::system_error` if an executor could not be pinned to its CPU.
+  ///
+  simple_scheduler(std::size_t num_executors, executor_placement placement)
+    : simple_scheduler{std::allocator_arg, std::pmr::get_default_resource(), num_executors, std::move(placement)} {
+  }
 
-    create_executors();
+  ///
+  /// Constructor, allocating the queue storage and job records (completion data, task adapters) from a memory
+  ///  resource, e.g. a `pool_resource`.
+  ///
+  /// \param resource      The memory resource to allocate from. Must outlive the scheduler, and all completion tokens
+  ///                      obtained from it.
+  /// \param num_executors The number of task executors. Must be between 1 and the number of execution cores.
+  /// \param placement     The executor placement (see the constructor without memory resource).
+  ///
+  /// \throws `std::underflow_error` if the provided amount of executors is 0.
+  /// \throws `std::overflow_error` if the provided amount of executors is greater than the number of execution cores.
+  /// \throws `std::invalid_argument` if the placement specifies NUMA nodes, but not for every CPU.
+  /// \throws `std::system_error` if an executor could not be pinned to its CPU.
+  ///
+  simple_scheduler(std::allocator_arg_t, std::pmr::memory_resource* resource, std::size_t num_executors,
+                   executor_placement placement = {})
+    : placement_{std::move(placement)}
+    , resource_{resource}
+    , job_pool_{(QueueMode == queue_mode::intrusive) ? std::make_unique<pool_resource>(resource) : nullptr}
+    , queue_{make_queue(max_executors(), placement_, job_pool_ ? job_pool_.get() : resource_)}
+    , injection_{resource_}
+    , deadline_queues_(max_executors())
+    , counters_(metrics_enabled ? max_executors() : 0) {
+    validate_num_executors(num_executors);
+    create_executors(num_executors);
   }
 
   ~simple_scheduler() {
-    std::unique_lock lock{work_mutex_};
-    std::ranges::for_each(executors_, [](auto& executor) { executor.request_stop(); });
-    work_cv_.notify_all();
+    disable_auto_scaling();
+    stop_executors(0);
+    stop_compensators();
   }
 
   simple_scheduler(const simple_scheduler&) noexcept            = delete;
   simple_scheduler& operator=(const simple_scheduler&) noexcept = delete;
 
+  ///
+  /// Get the maximum number of executors: the number of execution cores.
+  ///
+  /// \returns The maximum number of executors.
+  ///
+  [[nodiscard]] static std::size_t max_executors() noexcept {
+    return std::max(std::jthread::hardware_concurrency(), 1u);
+  }
+
   ///
   /// Get the number of executors.
   ///
   /// \returns The number of executors for this scheduler.
   ///
-  [[nodiscard]] constexpr std::size_t num_executors() const noexcept {
-    return executors_.size();
+  [[nodiscard]] std::size_t num_executors() const noexcept {
+    return num_executors_.load(std::memory_order_relaxed);
+  }
+
+  ///
+  /// Change the number of executors.
+  ///
+  /// When growing, new executors are started and take part in the load distribution. When shrinking, the executors
+  ///  with the highest indices are retired after finishing their current task, and their queued work is moved to the
+  ///  remaining executors. This call blocks until the retired executors have stopped.
+  ///
+  /// \param num_executors The number of task executors. Must be between 1 and the number of execution cores.
+  ///
+  /// \throws `std::logic_error` if called from within an executor.
+  /// \throws `std::underflow_error` if the provided amount of executors is 0.
+  /// \throws `std::overflow_error` if the provided amount of executors is greater than the number of execution cores.
+  /// \throws `std::system_error` if a new executor could not be pinned to its CPU.
+  ///
+  void resize(std::size_t num_executors) {
+    if (detail::current_executor() != nullptr) {
+      throw std::logic_error("Resizing from within an executor is not supported");
+    }
+
+    validate_num_executors(num_executors);
+
+    std::unique_lock lock{resize_mutex_};
+    const auto       current{executors_.size()};
+
+    if (num_executors > current) {
+      create_executors(num_executors);
+    } else if (num_executors < current) {
+      queue_.set_num_active_queues(num_executors);
+      num_executors_.store(num_executors, std::memory_order_seq_cst);
+
+      stop_executors(num_executors);
+
+      // Placements that selected a retired executor finish before its queue is migrated, see `placement_scope`.
+      while (placements_in_progress_.load(std::memory_order_seq_cst) != 0) {
+        std::this_thread::yield();
+      }
+
+      for (auto i{num_executors}; i < current; i++) {
+        queue_.migrate(i);
+        migrate_deadline_jobs(i);
+      }
+    }
+  }
+
+  ///
+  /// Enable automatic scaling of the number of executors, replacing any earlier policy. The scaling decisions are
+  ///  taken periodically on a separate thread.
+  ///
+  /// \param policy The auto-scaling policy.
+  ///
+  /// \throws `std::underflow_error` if the minimum number of executors is 0.
+  /// \throws `std::overflow_error` if the maximum number of executors is greater than the number of execution cores.
+  /// \throws `std::invalid_argument` if the minimum number of executors is greater than the maximum number.
+  ///
+  void enable_auto_scaling(scaling_policy policy) {
+    if (policy.min_executors > policy.max_executors) {
+      throw std::invalid_argument("Minimum number of executors must not exceed the maximum number");
+    }
+
+    validate_num_executors(policy.min_executors);
+    validate_num_executors(policy.max_executors);
+
+    disable_auto_scaling();
+    scaler_ = std::jthread{[this, policy](std::stop_token stop_token) { auto_scale(stop_token, policy); }};
+  }
+
+  ///
+  /// Disable automatic scaling of the number of executors. The current number of executors is retained.
+  ///
+  void disable_auto_scaling() {
+    scaler_ = {};
+  }
+
+  ///
+  /// Enable the LIFO slot (the default): a task scheduled or spawned from within a task runs next on the same exec-
+  ///  utor, while the task it displaces from the slot is queued regularly. This benefits message-passing workloads,
+  ///  where a task typically schedules a single follow-up task consuming the data it just produced, which is still
+  ///  in the cache. To prevent starvation of queued tasks, the slot is used at most three times in a row. A task left
+  ///  in the slot for longer than a short delay (e.g. while the task that scheduled it blocks) is stolen by an idle
+  ///  executor, so it cannot be held up by a blocked executor.
+  ///
+  void enable_lifo_slot() noexcept {
+    lifo_slot_enabled_.store(true, std::memory_order_relaxed);
+  }
+
+  ///
+  /// Disable the LIFO slot, so tasks scheduled or spawned from within a task are queued regularly (see
+  ///  `enable_lifo_slot`).
+  ///
+  void disable_lifo_slot() noexcept {
+    lifo_slot_enabled_.store(false, std::memory_order_relaxed);
   }
 
   ///
   /// Schedule a task.
   ///
-  /// Scheduling may fail if the associated queues are at their maximum capacity.
+  /// Scheduling does not fail: when the queues are at their maximum capacity, the task is held in the (unbounded)
+  ///  injection queue.
+  ///
+  /// \param task A function object to be processed.
+  ///
+  /// \returns An optional completion token that can be used to wait on for task completion. The optional value is
+  ///           always engaged.
   ///
-  /// \param task A function object to be processed. If scheduling failed, the task will be moved back.
+  [[nodiscard]] std::optional<completion_token> schedule(task<void()>&& task) {
+    auto completion{make_completion()};
+    schedule_job(std::move(task), completion);
+
+    return completion_token{completion};
+  }
+
+  ///
+  /// Schedule a task with a deadline.
+  ///
+  /// Tasks with a deadline are processed in earliest-deadline-first (EDF) order: every executor takes the task with
+  ///  the earliest deadline from its own deadline queue, or steals the earliest deadline of all executors if its own
+  ///  queue is empty. Tasks with a deadline take precedence over tasks without one, so the latter only run when no
+  ///  deadline tasks are pending. Scheduling may fail if the associated queues are at their maximum capacity.
+  ///
+  /// \param task     A function object to be processed. If scheduling failed, the task will be moved back.
+  /// \param deadline The time point at which the task should have started.
+  /// \param expiry   What to do with the task if it is picked up after its deadline.
   ///
   /// \returns An optional completion token. The optional value is empty if scheduling of the task failed (e.g. when
   ///           the underlying task queues are at their maximum capacity). If scheduling succeeds, the optional will
-  ///           hold a completion token that can be used to wait on for task completion.
+  ///           hold a completion token that can be used to wait on for task completion. A dropped task completes in
+  ///           the cancelled state.
   ///
-  [[nodiscard]] std::optional<completion_token> schedule(task<void()>&& task) {
-    auto completion{std::make_shared<detail::completion_data>()};
-    auto job{simple_job{std::move(task), completion}};
+  [[nodiscard]] std::optional<completion_token> schedule(task<void()>&& task,
+                                                         std::chrono::steady_clock::time_point deadline,
+                                                         expiry_policy expiry = expiry_policy::run) {
+    auto completion{make_completion()};
 
-    if (queue_.push(std::move(job))) {
-      work_cv_.notify_one();
+    if (schedule_deadline_job(std::move(task), completion, deadline, expiry)) {
       return completion_token{completion};
-    } else {
-      task = std::move(job.task_); // Hand back the task in case scheduling failed.
     }
 
     return {};
   }
 
+  ///
+  /// Schedule a cancellable task, which observes cancellation requests through a stop token while running.
+  ///
+  /// Scheduling does not fail: when the queues are at their maximum capacity, the task is held in the (unbounded)
+  ///  injection queue.
+  ///
+  /// \param task A function object to be processed, taking a stop token.
+  ///
+  /// \returns An optional completion token that can be used to wait on for task completion, and to request
+  ///           cancellation. The optional value is always engaged.
+  ///
+  [[nodiscard]] std::optional<completion_token> schedule(task<void(std::stop_token)>&& task) {
+    auto completion{make_completion(std::stop_source{})};
+    schedule_job(make_task(stoppable_task{std::move(task), completion->stop_token()}), completion);
+
+    return completion_token{completion};
+  }
+
+  ///
+  /// Schedule a task on a specific executor (soft affinity).
+  ///
+  /// The task is put in the local queue of the executor, bypassing the LIFO slot and the load distribution, so tasks
+  ///  working on the same data can be kept together on one core. The task may still be stolen by another executor,
+  ///  if the target executor is busy while others are idle. When the target queue is full, part of it is moved to the
+  ///  injection queue, so scheduling does not fail.
+  ///
+  /// \param executor_index The index of the executor to run the task on. Must be less than the number of executors.
+  /// \param task           A function object to be processed.
+  ///
+  /// \returns An optional completion token that can be used to wait on for task completion. The optional value is
+  ///           always engaged.
+  ///
+  /// \throws `std::out_of_range` if the executor index is out of range.
+  ///
+  [[nodiscard]] std::optional<completion_token> schedule_on(std::size_t executor_index, task<void()>&& task) {
+    const placement_scope scope{placements_in_progress_, num_executors_};
+
+    if (executor_index >= scope.num_executors()) {
+      throw std::out_of_range("Executor index out of range");
+    }
+
+    auto completion{make_completion()};
+    schedule_job_on(executor_index, std::move(task), completion);
+
+    return completion_token{completion};
+  }
+
+  ///
+  /// Schedule a task on the executor selected by hashing a key (soft affinity), so that all tasks with the same key
+  ///  are put on the same executor (see `schedule_on`). The mapping of keys to executors changes when the number of
+  ///  executors changes.
+  ///
+  /// \param key  The key to select the executor with, e.g. the identifier of a data shard.
+  /// \param task A function object to be processed.
+  /// \param hash The hash function object for the key.
+  ///
+  /// \returns An optional completion token that can be used to wait on for task completion. The optional value is
+  ///           always engaged.
+  ///
+  template<typename Key, typename Hash = std::hash<Key>>
+  [[nodiscard]] std::optional<completion_token> schedule_keyed(const Key& key, task<void()>&& task,
+                                                               const Hash& hash = {}) {
+    const placement_scope scope{placements_in_progress_, num_executors_};
+
+    auto completion{make_completion()};
+    schedule_job_on(hash(key) % scope.num_executors(), std::move(task), completion);
+
+    return completion_token{completion};
+  }
+
+  ///
+  /// Create a named partition, with its own queue.
+  ///
+  /// Tasks scheduled in a partition are isolated from the tasks of other partitions: the executors take turns between
+  ///  the partitions with pending work by weighted deficit round-robin, so a partition flooding the scheduler cannot
+  ///  starve the others. The tasks scheduled outside of any partition take part with a weight of 1. A partition that
+  ///  is restricted to executors that are not running (see `resize`) keeps its tasks queued until they are started.
+  ///
+  /// \param name   The unique name of the partition.
+  /// \param policy The weight of the partition, and optionally the executors it is restricted to.
+  ///
+  /// \returns The index of the partition, to schedule tasks with (see `schedule_in`).
+  ///
+  /// \throws `std::invalid_argument` if the name is already in use, if the weight is 0, or if an executor index is not
+  ///           less than the maximum number of executors.
+  /// \throws `std::length_error` if the maximum number of partitions is reached.
+  ///
+  std::size_t create_partition(std::string name, const partition_policy& policy = {}) {
+    if (policy.weight == 0) {
+      throw std::invalid_argument("Partition weight must be positive");
+    }
+
+    std::vector<bool> executors;
+
+    if (!policy.executors.empty()) {
+      executors.resize(max_executors());
+
+      for (const auto index : policy.executors) {
+        if (index >= max_executors()) {
+          throw std::invalid_argument("Partition executor index out of range");
+        }
+
+        executors[index] = true;
+      }
+    }
+
+    std::unique_lock lock{partitions_mutex_};
+
+    if (find_partition(name)) {
+      throw std::invalid_argument("Partition name already in use");
+    }
+
+    const auto index{num_partitions_.load(std::memory_order_relaxed)};
+
+    if (index >= MAX_PARTITIONS) {
+      throw std::length_error("Too many partitions");
+    }
+
+    partitions_[index] =
+      std::make_unique<partition_state>(std::move(name), policy.weight, std::move(executors), resource_);
+    num_partitions_.store(index + 1, std::memory_order_release);
+
+    return index;
+  }
+
+  ///
+  /// Find a partition by name.
+  ///
+  /// \param name The name of the partition.
+  ///
+  /// \returns An optional partition index. The optional is empty if there is no partition with the given name.
+  ///
+  [[nodiscard]] std::optional<std::size_t> find_partition(std::string_view name) const noexcept {
+    for (std::size_t i{}; i < num_partitions_.load(std::memory_order_acquire); i++) {
+      if (partitions_[i]->name_ == name) {
+        return i;
+      }
+    }
+
+    return {};
+  }
+
+  ///
+  /// Schedule a task in a partition (see `create_partition`).
+  ///
+  /// The task is held in the (unbounded) queue of the partition, so scheduling does not fail. Tasks scheduled in a
+  ///  partition bypass the LIFO slot.
+  ///
+  /// \param partition The index of the partition.
+  /// \param task      A function object to be processed.
+  ///
+  /// \returns An optional completion token that can be used to wait on for task completion. The optional value is
+  ///           always engaged.
+  ///
+  /// \throws `std::out_of_range` if the partition index is out of range.
+  ///
+  [[nodiscard]] std::optional<completion_token> schedule_in(std::size_t partition, task<void()>&& task) {
+    if (partition >= num_partitions_.load(std::memory_order_acquire)) {
+      throw std::out_of_range("Partition index out of range");
+    }
+
+    auto  completion{make_completion()};
+    auto& target{*partitions_[partition]};
+
+    target.queue_.push(make_job(std::move(task), completion));
+
+    // Only some of the executors may run the tasks of a restricted partition, so wake all of them.
+    notify_idle_executor(!target.executors_.empty());
+
+    return completion_token{completion};
+  }
+
+  ///
+  /// Schedule a task taking the context of the executor it runs on, e.g. to allocate temporary memory from its arena.
+  ///
+  /// Scheduling does not fail: when the queues are at their maximum capacity, the task is held in the (unbounded)
+  ///  injection queue.
+  ///
+  /// \param task A function object to be processed, taking an executor context.
+  ///
+  /// \returns An optional completion token that can be used to wait on for task completion. The optional value is
+  ///           always engaged.
+  ///
+  [[nodiscard]] std::optional<completion_token> schedule(task<void(executor_context&)>&& task) {
+    auto completion{make_completion()};
+    schedule_job(make_task(contextual_task{std::move(task)}), completion);
+
+    return completion_token{completion};
+  }
+
+  ///
+  /// Schedule a function to be called for every index in the range `0..count`, with a single completion token.
+  ///
+  /// The function is stored once. The index range is divided in chunks, which are claimed by at most one job per
+  ///  executor through an atomic counter, so the overhead per chunk is a single atomic read-modify-write. Finished
+  ///  indices are counted once per job, when it runs out of chunks. If a call throws, the remaining indices are
+  ///  skipped, and the exception is reported through the completion token. If cancellation is requested, the
+  ///  remaining indices are skipped, and the token completes in the cancelled state.
+  ///
+  /// \param count      The number of indices.
+  /// \param function   A function object to be called for every index.
+  /// \param chunk_size The number of indices per chunk. If zero, the chunk size is selected such that every executor
+  ///                   claims several chunks, for load balancing.
+  ///
+  /// \returns An optional completion token that can be used to wait on for completion of all indices, and to request
+  ///           cancellation. The optional value is always engaged.
+  ///
+  [[nodiscard]] std::optional<completion_token> schedule_n(std::size_t count, task<void(std::size_t)>&& function,
+                                                           std::size_t chunk_size = 0) {
+    auto completion{make_completion()};
+
+    if (count == 0) {
+      completion->trigger_completion();
+      return completion_token{completion};
+    }
+
+    const auto num_workers{num_executors()};
+
+    if (chunk_size == 0) {
+      chunk_size = std::max(count / (num_workers * BULK_CHUNKS_PER_EXECUTOR), std::size_t{1});
+    }
+
+    const auto num_chunks{(count - 1) / chunk_size + 1};
+    auto       state{std::allocate_shared<bulk_state>(std::pmr::polymorphic_allocator<bulk_state>{resource_},
+                                                    std::move(function), count, chunk_size, completion)};
+
+    for (std::size_t i{}; i < std::min(num_chunks, num_workers); i++) {
+      schedule_job(make_task([state] { (*state)(); }), nullptr);
+    }
+
+    return completion_token{completion};
+  }
+
+  ///
+  /// Schedule a detached (fire-and-forget) task.
+  ///
+  /// No completion state is kept for detached tasks, so they cannot be waited on or cancelled individually. This
+  ///  saves the allocation and signalling of the completion state. Exceptions thrown by detached tasks are passed to
+  ///  the exception handler (see `set_exception_handler`). Use `wait_idle` to wait for all tasks to complete.
+  ///
+  /// \param task A function object to be processed.
+  ///
+  void schedule_detached(task<void()>&& task) {
+    schedule_job(std::move(task), nullptr);
+  }
+
+  ///
+  /// Set the exception handler for detached tasks, replacing any earlier handler. Without a handler, exceptions
+  ///  thrown by detached tasks are discarded.
+  ///
+  /// \param handler The exception handler. It is called on the executor that ran the failing task. Exceptions thrown
+  ///                by the handler itself are discarded.
+  ///
+  void set_exception_handler(std::function<void(std::exception_ptr)> handler) {
+    std::unique_lock lock{exception_handler_mutex_};
+    exception_handler_ = std::move(handler);
+  }
+
+  ///
+  /// Blocking wait until the scheduler is idle: all scheduled tasks (detached or not) have completed, or were flushed.
+  ///
+  /// \throws `std::logic_error` if called from within an executor.
+  ///
+  void wait_idle() const {
+    if (local_executor() != nullptr) {
+      throw std::logic_error("Waiting for idle from within an executor is not supported");
+    }
+
+    for (auto count{in_flight_.load(std::memory_order_acquire)}; count > 0;
+         count = in_flight_.load(std::memory_order_acquire)) {
+      in_flight_.wait(count, std::memory_order_acquire);
+    }
+  }
+
   ///
   /// Flush all underlying queues, removing all waiting tasks. Tasks that are already in execution will be not be
   ///  stopped forcefully, and have to be handled using the associated completion tokens.
   ///
   void flush() {
-    queue_.flush();
+    auto count{queue_.flush() + injection_.flush()};
+
+    for (std::size_t i{}; i < num_partitions_.load(std::memory_order_acquire); i++) {
+      count += partitions_[i]->queue_.flush();
+    }
+
+    for (auto& queue : deadline_queues_) {
+      const auto size{queue.flush()};
+      deadline_occupancy_.fetch_sub(static_cast<std::ptrdiff_t>(size), std::memory_order_relaxed);
+      count += size;
+    }
+
+    finish_jobs(count);
+  }
+
+  ///
+  /// Get a snapshot of the runtime metrics. Only available when compiled with `TS_ENABLE_METRICS`.
+  ///
+  /// The counters of the executors are read individually without synchronization, so the snapshot is not an atomic
+  ///  view of the scheduler state.
+  ///
+  /// \returns The runtime metrics per executor, and scheduler-wide.
+  ///
+  [[nodiscard]] scheduler_metrics metrics() const requires(metrics_enabled) {
+    scheduler_metrics result;
+    result.executors.reserve(num_executors());
+
+    for (std::size_t id{}; id < num_executors(); id++) {
+      auto& executor{result.executors.emplace_back(counters_[id].snapshot())};
+      executor.queue_depth = queue_.queue_size(id) + deadline_queues_[id].size();
+    }
+
+    result.schedule_rejections   = schedule_rejections_.load(std::memory_order_relaxed);
+    result.injection_queue_depth = injection_.size();
+
+    return result;
   }
 };
 
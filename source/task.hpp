@@ -3,6 +3,8 @@
 #include <concepts>
 #include <functional>
 #include <memory>
+#include <memory_resource>
+#include <new>
 #include <type_traits>
 #include <utility>
 
@@ -16,28 +18,68 @@ class task;
 ///
 /// Task wrapper to hold type-erased callables like function objects and function pointers.
 ///
+/// The callable is stored on the heap, or in memory obtained from a memory resource (see the `std::allocator_arg_t`
+///  constructor). In the latter case, the memory resource must outlive the task.
+///
 template<typename Ret, typename... Args>
 class task<Ret(Args...)> final {
   struct concept_t {
-    virtual ~concept_t()         = default;
-    virtual Ret invoke_(Args...) = 0;
+    virtual ~concept_t()             = default;
+    virtual Ret  invoke_(Args...)    = 0;
+    virtual void destroy_() noexcept = 0;
   };
 
   template<typename T>
   struct model_t final : concept_t {
     template<typename U = T>
-    explicit model_t(U&& value)
-      : value_{std::forward<U>(value)} {
+    explicit model_t(std::pmr::memory_resource* resource, U&& value)
+      : resource_{resource}
+      , value_{std::forward<U>(value)} {
     }
 
     Ret invoke_(Args... args) override {
       return std::invoke(value_, std::forward<Args>(args)...);
     }
 
-    T value_;
+    void destroy_() noexcept override {
+      if (resource_ == nullptr) {
+        delete this;
+      } else {
+        auto* resource{resource_};
+        this->~model_t();
+        resource->deallocate(this, sizeof(model_t), alignof(model_t));
+      }
+    }
+
+    std::pmr::memory_resource* resource_;
+    T                          value_;
+  };
+
+  struct destroyer {
+    void operator()(concept_t* model) const noexcept {
+      model->destroy_();
+    }
   };
 
-  std::unique_ptr<concept_t> model_;
+  template<typename T>
+  [[nodiscard]] static concept_t* make_model(std::pmr::memory_resource* resource, T&& value) {
+    using model = model_t<std::decay_t<T>>;
+
+    if (resource == nullptr) {
+      return new model{nullptr, std::forward<T>(value)};
+    }
+
+    auto* memory{resource->allocate(sizeof(model), alignof(model))};
+
+    try {
+      return ::new (memory) model{resource, std::forward<T>(value)};
+    } catch (...) {
+      resource->deallocate(memory, sizeof(model), alignof(model));
+      throw;
+    }
+  }
+
+  std::unique_ptr<concept_t, destroyer> model_;
 
 public:
   constexpr task() = default;
@@ -49,7 +91,19 @@ public:
   ///
   template<typename T>
   requires(std::is_invocable_r_v<Ret, T, Args...> && !std::same_as<std::decay_t<T>, task>) task(T&& value)
-    : model_{std::make_unique<model_t<std::decay_t<T>>>(std::forward<T>(value))} {
+    : model_{make_model(nullptr, std::forward<T>(value))} {
+  }
+
+  ///
+  /// Constructor, storing the callable object in memory obtained from a memory resource.
+  ///
+  /// \param resource The memory resource to allocate from. Must outlive the task. If `nullptr`, the heap is used.
+  /// \param value    The callable object to wrap.
+  ///
+  template<typename T>
+  requires(std::is_invocable_r_v<Ret, T, Args...> && !std::same_as<std::decay_t<T>, task>)
+    task(std::allocator_arg_t, std::pmr::memory_resource* resource, T&& value)
+    : model_{make_model(resource, std::forward<T>(value))} {
   }
 
   task(task&&) noexcept            = default;
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+#include "completion_token.hpp"
+#include "executor_context.hpp"
+#include "executor_interface.hpp"
+#include "task.hpp"
+
+namespace ts {
+
+inline namespace v1 {
+
+///
+/// Functions to interact with the scheduler executor running the current task.
+///
+namespace this_executor {
+
+///
+/// Check if the current thread is a scheduler executor.
+///
+/// \returns `true` if called from within a task running on an executor, `false` if otherwise.
+///
+[[nodiscard]] inline bool is_executor() noexcept {
+  return (detail::current_executor() != nullptr);
+}
+
+///
+/// Get the context of the executor running the current task, e.g. to allocate temporary memory from its arena.
+///
+/// \returns A reference to the executor context.
+///
+/// \throws `std::logic_error` if not called from within a task running on an executor.
+///
+[[nodiscard]] inline executor_context& context() {
+  auto* executor{detail::current_executor()};
+
+  if (executor == nullptr) {
+    throw std::logic_error("Executor context requires a running executor");
+  }
+
+  return executor->context();
+}
+
+///
+/// Spawn a (sub)task from within a running task.
+///
+/// The task is pushed onto the queue of the current executor, bypassing the uniform load distribution of regular
+///  scheduling. Idle executors will steal the work when possible. This keeps related work together, which benefits
+///  divide-and-conquer workloads. If the queue of the current executor is full, the scheduler may move part of it
+///  to a global queue, so that the task is still accepted. The completion data is allocated from the memory resource
+///  of the scheduler.
+///
+/// \param task A function object to be processed. If spawning failed, the task will be moved back.
+///
+/// \returns An optional completion token. The optional value is empty if the scheduler did not accept the task. This
+///           does not happen with `simple_scheduler`, which moves work out of a full executor queue instead.
+///
+/// \throws `std::logic_error` if not called from within a task running on an executor.
+///
+[[nodiscard]] inline std::optional<completion_token> spawn(task<void()>&& task) {
+  auto* executor{detail::current_executor()};
+
+  if (executor == nullptr) {
+    throw std::logic_error("Spawning requires a running executor");
+  }
+
+  auto completion{std::allocate_shared<detail::completion_data>(
+    std::pmr::polymorphic_allocator<detail::completion_data>{executor->resource()})};
+
+  if (executor->spawn(std::move(task), completion)) {
+    return completion_token{completion};
+  }
+
+  return {};
+}
+
+} // namespace this_executor
+
+} // namespace v1
+
+} // namespace ts
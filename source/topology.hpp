@@ -0,0 +1,196 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace ts {
+
+inline namespace v1 {
+
+///
+/// List of logical CPU indices.
+///
+using cpu_list = std::vector<unsigned int>;
+
+///
+/// NUMA node description: the node index and the CPUs that belong to it.
+///
+struct numa_node {
+  unsigned int id;
+  cpu_list     cpus;
+};
+
+///
+/// Executor placement: the CPUs to pin executors to, and the NUMA node per CPU.
+///
+/// Executor `i` is pinned to CPU `cpus[i % cpus.size()]`. When `nodes` is set, it must have the same length as `cpus`,
+///  and executors will prefer to steal work from executors on the same NUMA node before crossing nodes.
+///
+struct executor_placement {
+  cpu_list                  cpus;
+  std::vector<unsigned int> nodes;
+};
+
+///
+/// Parse a CPU list in the Linux sysfs format (e.g. "0-3,8,10-11").
+///
+/// \param list The CPU list string.
+///
+/// \returns The parsed list of CPU indices, in order of appearance.
+///
+/// \throws `std::invalid_argument` if the CPU list is malformed.
+///
+[[nodiscard]] inline cpu_list parse_cpu_list(std::string_view list) {
+  const auto parse_cpu = [](std::string_view text) {
+    unsigned int cpu{};
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), cpu);
+
+    if ((error != std::errc{}) || (end != text.data() + text.size())) {
+      throw std::invalid_argument("Malformed CPU list");
+    }
+
+    return cpu;
+  };
+
+  cpu_list result;
+
+  while (!list.empty() && ((list.back() == '\n') || (list.back() == ' '))) {
+    list.remove_suffix(1);
+  }
+
+  while (!list.empty()) {
+    const auto range_end{std::min(list.find(','), list.size())};
+    const auto range{list.substr(0, range_end)};
+
+    if (const auto separator{range.find('-')}; separator != std::string_view::npos) {
+      const auto first{parse_cpu(range.substr(0, separator))};
+      const auto last{parse_cpu(range.substr(separator + 1))};
+
+      if (first > last) {
+        throw std::invalid_argument("Malformed CPU list");
+      }
+
+      for (auto cpu{first}; cpu <= last; cpu++) {
+        result.push_back(cpu);
+      }
+    } else {
+      result.push_back(parse_cpu(range));
+    }
+
+    list.remove_prefix(std::min(range_end + 1, list.size()));
+  }
+
+  return result;
+}
+
+///
+/// Read the NUMA topology from sysfs.
+///
+/// \param root The sysfs NUMA node directory.
+///
+/// \returns The NUMA nodes, ordered by node index. If no topology information is available, a single node holding all
+///           hardware threads is returned.
+///
+[[nodiscard]] inline std::vector<numa_node> read_numa_topology(
+  const std::filesystem::path& root = "/sys/devices/system/node") {
+  std::vector<numa_node> nodes;
+  std::error_code        error;
+
+  for (const auto& entry : std::filesystem::directory_iterator{root, error}) {
+    const auto name{entry.path().filename().string()};
+
+    if (!name.starts_with("node") || (name.size() == 4)
+        || !std::all_of(name.begin() + 4, name.end(), [](char c) { return (c >= '0') && (c <= '9'); })) {
+      continue;
+    }
+
+    std::ifstream file{entry.path() / "cpulist"};
+    std::string   list;
+
+    if (!std::getline(file, list)) {
+      continue;
+    }
+
+    if (auto cpus{parse_cpu_list(list)}; !cpus.empty()) {
+      nodes.push_back({static_cast<unsigned int>(std::stoul(name.substr(4))), std::move(cpus)});
+    }
+  }
+
+  if (nodes.empty()) {
+    cpu_list cpus(std::max(std::thread::hardware_concurrency(), 1u));
+    std::ranges::generate(cpus, [cpu = 0u]() mutable { return cpu++; });
+
+    nodes.push_back({0, std::move(cpus)});
+  }
+
+  std::ranges::sort(nodes, {}, &numa_node::id);
+
+  return nodes;
+}
+
+///
+/// Create an executor placement that groups executors by NUMA node.
+///
+/// \param topology The NUMA topology (see `read_numa_topology`).
+///
+/// \returns An executor placement assigning the CPUs node by node.
+///
+[[nodiscard]] inline executor_placement numa_placement(const std::vector<numa_node>& topology) {
+  executor_placement placement;
+
+  for (const auto& node : topology) {
+    placement.cpus.insert(placement.cpus.end(), node.cpus.begin(), node.cpus.end());
+    placement.nodes.insert(placement.nodes.end(), node.cpus.size(), node.id);
+  }
+
+  return placement;
+}
+
+namespace detail {
+
+///
+/// Pin a thread to a single CPU.
+///
+/// \param thread The native thread handle.
+/// \param cpu    The CPU index.
+///
+/// \throws `std::system_error` if the thread affinity could not be set.
+///
+inline void pin_thread(std::thread::native_handle_type thread, unsigned int cpu) {
+#ifdef __linux__
+  if (cpu >= CPU_SETSIZE) {
+    throw std::system_error(std::make_error_code(std::errc::invalid_argument), "CPU index out of range");
+  }
+
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+
+  if (const auto result{pthread_setaffinity_np(thread, sizeof(set), &set)}; result != 0) {
+    throw std::system_error(result, std::generic_category(), "Failed to set executor CPU affinity");
+  }
+#else
+  (void)thread;
+  (void)cpu;
+#endif
+}
+
+} // namespace detail
+
+} // namespace v1
+
+} // namespace ts
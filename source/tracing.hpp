@@ -0,0 +1,404 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace ts {
+
+inline namespace v1 {
+
+///
+/// Compile-time switch for task lifecycle tracing. Define `TS_ENABLE_TRACING` to compile in tracing support. When
+///  compiled in, tracing is still inactive until started at runtime (see `tracing::start`). In that case, the
+///  overhead on the scheduler hot paths is a single branch.
+///
+#ifdef TS_ENABLE_TRACING
+static constexpr bool tracing_enabled{true};
+#else
+static constexpr bool tracing_enabled{false};
+#endif
+
+namespace detail {
+
+enum class trace_event_type : std::uint8_t {
+  scheduled,
+  rejected,
+  dequeued_local,
+  dequeued_stolen,
+  started,
+  finished,
+  cancelled
+};
+
+struct trace_event {
+  std::int64_t     timestamp_ns;
+  std::uint64_t    job_id;
+  trace_event_type type;
+};
+
+///
+/// Per-thread trace event ring buffer. Only the owning thread writes events. When the buffer is full, the oldest
+///  events are overwritten.
+///
+class trace_buffer final {
+public:
+  static constexpr std::size_t CAPACITY{1 << 14};
+
+private:
+  std::array<trace_event, CAPACITY> events_;
+  std::atomic<std::uint64_t>        head_{};
+  std::string                       name_;
+  unsigned int                      thread_index_;
+  bool                              retired_{}; // Owning thread has exited, guarded by the registry.
+
+public:
+  explicit trace_buffer(unsigned int thread_index)
+    : events_{}
+    , name_{"thread " + std::to_string(thread_index)}
+    , thread_index_{thread_index} {
+  }
+
+  void record(trace_event_type type, std::uint64_t job_id) noexcept {
+    const auto head{head_.load(std::memory_order_relaxed)};
+    const auto now{std::chrono::steady_clock::now().time_since_epoch()};
+
+    events_[head % CAPACITY] = {std::chrono::duration_cast<std::chrono::nanoseconds>(now).count(), job_id, type};
+    head_.store(head + 1, std::memory_order_release);
+  }
+
+  template<typename Function>
+  void for_each(Function&& function) const {
+    const auto head{head_.load(std::memory_order_acquire)};
+
+    for (auto i{(head > CAPACITY) ? (head - CAPACITY) : 0}; i < head; i++) {
+      function(events_[i % CAPACITY]);
+    }
+  }
+
+  void clear() noexcept {
+    head_.store(0, std::memory_order_release);
+  }
+
+  [[nodiscard]] bool empty() const noexcept {
+    return (head_.load(std::memory_order_acquire) == 0);
+  }
+
+  void set_name(std::string name) {
+    name_ = std::move(name);
+  }
+
+  [[nodiscard]] const std::string& name() const noexcept {
+    return name_;
+  }
+
+  [[nodiscard]] unsigned int thread_index() const noexcept {
+    return thread_index_;
+  }
+
+  void retire() noexcept {
+    retired_ = true;
+  }
+
+  [[nodiscard]] bool retired() const noexcept {
+    return retired_;
+  }
+};
+
+// Whether tracing is started. Kept at namespace scope rather than in the registry, so checking it on the hot paths
+//  is a plain load, without the initialization guard of a function-local static.
+inline std::atomic<bool> trace_active{false};
+
+class trace_registry final {
+  std::atomic<std::uint64_t>                 next_job_id_{1};
+  mutable std::mutex                         mutex_;
+  std::vector<std::shared_ptr<trace_buffer>> buffers_;
+  unsigned int                               next_thread_index_{};
+
+public:
+  [[nodiscard]] static trace_registry& instance() {
+    static trace_registry registry;
+    return registry;
+  }
+
+  [[nodiscard]] std::uint64_t next_job_id() noexcept {
+    return next_job_id_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] std::shared_ptr<trace_buffer> create_buffer(std::string name) {
+    std::unique_lock lock{mutex_};
+    auto             buffer{std::make_shared<trace_buffer>(next_thread_index_++)};
+
+    if (!name.empty()) {
+      buffer->set_name(std::move(name));
+    }
+
+    return buffers_.emplace_back(std::move(buffer));
+  }
+
+  void set_name(trace_buffer& buffer, std::string name) {
+    std::unique_lock lock{mutex_};
+    buffer.set_name(std::move(name));
+  }
+
+  ///
+  /// Release the buffer of an exiting thread. A buffer without events is dropped, otherwise it is kept for export
+  ///  until the next `clear`.
+  ///
+  void release_buffer(const std::shared_ptr<trace_buffer>& buffer) {
+    std::unique_lock lock{mutex_};
+
+    if (buffer->empty()) {
+      std::erase(buffers_, buffer);
+    } else {
+      buffer->retire();
+    }
+  }
+
+  ///
+  /// Remove all recorded events, and drop the buffers of threads that have exited.
+  ///
+  void clear() {
+    std::unique_lock lock{mutex_};
+
+    std::erase_if(buffers_, [](const auto& buffer) { return buffer->retired(); });
+
+    for (const auto& buffer : buffers_) {
+      buffer->clear();
+    }
+  }
+
+  template<typename Function>
+  void for_each(Function&& function) const {
+    std::unique_lock lock{mutex_};
+
+    for (const auto& buffer : buffers_) {
+      function(*buffer);
+    }
+  }
+};
+
+///
+/// Per-thread trace state. The trace buffer is only created when the thread records its first event, so naming a
+///  thread that never records (e.g. while tracing is inactive) does not allocate a buffer.
+///
+class trace_thread final {
+  std::string                   name_;
+  std::shared_ptr<trace_buffer> buffer_;
+
+public:
+  trace_thread() = default;
+
+  trace_thread(const trace_thread&)            = delete;
+  trace_thread& operator=(const trace_thread&) = delete;
+
+  ~trace_thread() {
+    if (buffer_) {
+      trace_registry::instance().release_buffer(buffer_);
+    }
+  }
+
+  [[nodiscard]] trace_buffer& buffer() {
+    if (!buffer_) {
+      buffer_ = trace_registry::instance().create_buffer(name_);
+    }
+
+    return *buffer_;
+  }
+
+  void set_name(std::string name) {
+    if (buffer_) {
+      trace_registry::instance().set_name(*buffer_, name);
+    }
+
+    name_ = std::move(name);
+  }
+};
+
+[[nodiscard]] inline trace_thread& local_trace_thread() {
+  static thread_local trace_thread thread;
+  return thread;
+}
+
+[[nodiscard]] inline trace_buffer& local_trace_buffer() {
+  return local_trace_thread().buffer();
+}
+
+///
+/// Check if tracing is active. Always `false` if tracing is not compiled in.
+///
+[[nodiscard]] inline bool tracing_active() noexcept {
+  if constexpr (tracing_enabled) {
+    return trace_active.load(std::memory_order_relaxed);
+  } else {
+    return false;
+  }
+}
+
+///
+/// Get a new job ID for tracing, or 0 (untraced) if tracing is inactive.
+///
+[[nodiscard]] inline std::uint64_t trace_job_id() noexcept {
+  if (tracing_active()) [[unlikely]] {
+    return trace_registry::instance().next_job_id();
+  }
+
+  return 0;
+}
+
+///
+/// Record a trace event for a job on the current thread. Jobs without a trace ID (scheduled while tracing was
+///  inactive) are ignored.
+///
+inline void trace(trace_event_type type, std::uint64_t job_id) {
+  if (tracing_active() && (job_id != 0)) [[unlikely]] {
+    local_trace_buffer().record(type, job_id);
+  }
+}
+
+///
+/// Name the current thread in the trace output.
+///
+inline void trace_thread_name(std::string name) {
+  if constexpr (tracing_enabled) {
+    local_trace_thread().set_name(std::move(name));
+  }
+}
+
+///
+/// Write a string as JSON string contents, escaping quotes, backslashes and control characters.
+///
+inline void write_json_escaped(std::ostream& stream, std::string_view text) {
+  static constexpr std::string_view HEX_DIGITS{"0123456789abcdef"};
+
+  for (const auto c : text) {
+    switch (c) {
+    case '"': stream << "\\\""; break;
+    case '\\': stream << "\\\\"; break;
+    case '\b': stream << "\\b"; break;
+    case '\f': stream << "\\f"; break;
+    case '\n': stream << "\\n"; break;
+    case '\r': stream << "\\r"; break;
+    case '\t': stream << "\\t"; break;
+    default:
+      if (const auto code{static_cast<unsigned char>(c)}; code < 0x20) {
+        stream << "\\u00" << HEX_DIGITS[code >> 4] << HEX_DIGITS[code & 0xf];
+      } else {
+        stream << c;
+      }
+      break;
+    }
+  }
+}
+
+} // namespace detail
+
+///
+/// Task lifecycle tracing control and export. Only functional when compiled with `TS_ENABLE_TRACING`.
+///
+/// Every thread records events into its own lock-free ring buffer: when a job is scheduled (or rejected), dequeued
+///  (locally or by stealing), started and finished (or skipped when cancelled). The events can be exported in the
+///  Chrome trace event format, which can be loaded in Perfetto or `chrome://tracing`.
+///
+namespace tracing {
+
+///
+/// Start recording trace events.
+///
+inline void start() noexcept {
+  detail::trace_active.store(true, std::memory_order_relaxed);
+}
+
+///
+/// Stop recording trace events.
+///
+inline void stop() noexcept {
+  detail::trace_active.store(false, std::memory_order_relaxed);
+}
+
+///
+/// Check if trace events are being recorded.
+///
+/// \returns `true` if tracing is compiled in and started, `false` if otherwise.
+///
+[[nodiscard]] inline bool is_active() noexcept {
+  return detail::tracing_active();
+}
+
+///
+/// Remove all recorded trace events, including those of threads that have exited. Must only be called when tracing
+///  is stopped and all traced jobs have finished.
+///
+inline void clear() {
+  detail::trace_registry::instance().clear();
+}
+
+///
+/// Write the recorded trace events in the Chrome trace event (JSON) format. Must only be called when tracing is
+///  stopped and all traced jobs have finished.
+///
+/// \param stream The output stream to write to.
+///
+inline void write_chrome_trace(std::ostream& stream) {
+  using detail::trace_event_type;
+
+  const auto write_event = [&](const detail::trace_buffer& buffer, const detail::trace_event& event) {
+    const auto tid{buffer.thread_index()};
+    const auto ts{static_cast<double>(event.timestamp_ns) / 1'000.0};
+
+    const auto write = [&](const char* name, const char* phase, const char* extra) {
+      stream << ",\n{\"name\":\"" << name << "\",\"cat\":\"job\",\"ph\":\"" << phase << "\",\"pid\":1,\"tid\":" << tid
+             << ",\"ts\":" << ts << ",\"id\":" << event.job_id << extra << ",\"args\":{\"job\":" << event.job_id
+             << "}}";
+    };
+
+    switch (event.type) {
+    case trace_event_type::scheduled:
+      write("schedule", "i", ",\"s\":\"t\"");
+      write("job", "s", "");
+      break;
+    case trace_event_type::rejected: write("rejected", "i", ",\"s\":\"t\""); break;
+    case trace_event_type::dequeued_local: write("dequeue (local)", "i", ",\"s\":\"t\""); break;
+    case trace_event_type::dequeued_stolen: write("dequeue (steal)", "i", ",\"s\":\"t\""); break;
+    case trace_event_type::started:
+      write("job", "B", "");
+      write("job", "f", ",\"bp\":\"e\"");
+      break;
+    case trace_event_type::finished: write("job", "E", ""); break;
+    case trace_event_type::cancelled:
+      write("cancelled", "i", ",\"s\":\"t\"");
+      write("job", "f", ",\"bp\":\"e\"");
+      break;
+    }
+  };
+
+  stream.precision(3);
+  stream << std::fixed << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+  stream << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"task-scheduler\"}}";
+
+  detail::trace_registry::instance().for_each([&](const detail::trace_buffer& buffer) {
+    stream << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer.thread_index()
+           << ",\"args\":{\"name\":\"";
+    detail::write_json_escaped(stream, buffer.name());
+    stream << "\"}}";
+
+    buffer.for_each([&](const detail::trace_event& event) { write_event(buffer, event); });
+  });
+
+  stream << "\n]}\n";
+}
+
+} // namespace tracing
+
+} // namespace v1
+
+} // namespace ts
@@ -6,11 +6,60 @@
 #include <chrono>
 #include <exception>
 #include <memory>
+#include <memory_resource>
 #include <stdexcept>
+#include <stop_token>
 #include <thread>
+#include <utility>
 
 using namespace ts;
 
+class helping_executor final : public detail::executor_interface {
+  std::shared_ptr<detail::completion_data> data_;
+  unsigned int                             pending_jobs_;
+  executor_context                         context_{0};
+
+public:
+  helping_executor(std::shared_ptr<detail::completion_data> data, unsigned int pending_jobs)
+    : data_{std::move(data)}
+    , pending_jobs_{pending_jobs} {
+  }
+
+  [[nodiscard]] bool run_pending_job() override {
+    if (pending_jobs_ == 0) {
+      return false;
+    }
+
+    if (--pending_jobs_ == 0) {
+      data_->trigger_completion();
+    }
+
+    return true;
+  }
+
+  [[nodiscard]] bool spawn(task<void()>&&, std::shared_ptr<detail::completion_data>) override {
+    return false;
+  }
+
+  void begin_blocking() override {
+  }
+
+  void end_blocking() override {
+  }
+
+  [[nodiscard]] executor_context& context() noexcept override {
+    return context_;
+  }
+
+  [[nodiscard]] std::pmr::memory_resource* resource() const noexcept override {
+    return std::pmr::get_default_resource();
+  }
+
+  [[nodiscard]] unsigned int pending_jobs() const {
+    return pending_jobs_;
+  }
+};
+
 TEST_SUITE("completion_data") {
   using namespace detail;
 
@@ -43,6 +92,37 @@ TEST_SUITE("completion_data") {
 
     CHECK(d.exception());
   }
+
+  TEST_CASE("Cancellation") {
+    completion_data d;
+
+    CHECK_FALSE(d.stop_requested());
+    CHECK_FALSE(d.stop_token().stop_possible());
+
+    CHECK(d.request_stop());
+    CHECK_FALSE(d.request_stop());
+    CHECK(d.stop_requested());
+    CHECK_FALSE(d.is_completed());
+    CHECK_FALSE(d.is_cancelled());
+
+    d.trigger_cancellation();
+
+    CHECK(d.is_completed());
+    CHECK(d.is_cancelled());
+  }
+
+  TEST_CASE("Cancellation with a stop state") {
+    completion_data d{std::stop_source{}};
+
+    const auto token = d.stop_token();
+
+    REQUIRE(token.stop_possible());
+    CHECK_FALSE(token.stop_requested());
+
+    CHECK(d.request_stop());
+
+    CHECK(token.stop_requested());
+  }
 }
 
 TEST_SUITE("completion_token") {
@@ -75,6 +155,37 @@ TEST_SUITE("completion_token") {
     CHECK(duration_cast<milliseconds>(time_end - time_start).count() >= 100);
   }
 
+  TEST_CASE("Completion handling from an executor (caller-helps waiting)" * doctest::timeout(1)) {
+    auto             data = std::make_shared<detail::completion_data>();
+    completion_token t{data};
+    helping_executor executor{data, 3};
+
+    auto* previous = std::exchange(detail::current_executor(), &executor);
+
+    t.wait();
+
+    detail::current_executor() = previous;
+
+    CHECK(t);
+    CHECK(executor.pending_jobs() == 0);
+  }
+
+  TEST_CASE("Cancellation handling") {
+    auto             data = std::make_shared<detail::completion_data>();
+    completion_token t{data};
+
+    CHECK_FALSE(t.stop_requested());
+    CHECK(t.request_stop());
+    CHECK(t.stop_requested());
+    CHECK(data->stop_requested());
+    CHECK_FALSE(t.cancelled());
+
+    data->trigger_cancellation();
+
+    CHECK(t);
+    CHECK(t.cancelled());
+  }
+
   TEST_CASE("Exception handling") {
     auto             data = std::make_shared<detail::completion_data>();
     completion_token t{data};
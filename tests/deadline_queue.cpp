@@ -0,0 +1,153 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "../source/deadline_queue.hpp"
+
+#include <doctest/doctest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+
+struct move_only {
+  move_only() = default;
+
+  move_only(move_only&&)            = default;
+  move_only& operator=(move_only&&) = default;
+};
+
+using namespace ts;
+using namespace std::chrono_literals;
+
+using test_queue = deadline_queue<unsigned int, 10, 4>;
+
+static const auto NOW = test_queue::clock::now();
+
+TEST_SUITE("deadline_queue") {
+  TEST_CASE("Default construction") {
+    test_queue x;
+
+    CHECK(x.max_size() == 10);
+    CHECK(x.num_buckets() == 4);
+    CHECK(x.bucket_width() == test_queue::default_bucket_width);
+  }
+
+  TEST_CASE("Construction (failure cases)") {
+    CHECK_THROWS_AS(test_queue{0ns}, std::invalid_argument);
+    CHECK_THROWS_AS(test_queue{-1ms}, std::invalid_argument);
+  }
+
+  TEST_CASE("Cache line alignment") {
+    CHECK(alignof(test_queue) == cache_line_size);
+    CHECK(sizeof(test_queue) % cache_line_size == 0);
+  }
+
+  TEST_CASE("Pushing elements") {
+    test_queue x;
+
+    CHECK(x.empty());
+
+    for (unsigned int i = 0; i < 10; i++) {
+      REQUIRE(x.size() == i);
+      CHECK(x.push(NOW, 42u));
+    }
+
+    REQUIRE(x.size() == 10);
+    CHECK_FALSE(x.empty());
+
+    CHECK_FALSE(x.push(NOW, 42u));
+
+    REQUIRE(x.size() == 10);
+  }
+
+  TEST_CASE("Popping elements in deadline order") {
+    test_queue x{1ms};
+
+    // Deadlines spread over multiple calendar years, pushed out of order.
+    const unsigned int offsets[] = {7, 3, 0, 12, 5, 1, 30, 9, 2, 4};
+
+    for (const auto offset : offsets) {
+      REQUIRE(x.push(NOW + offset * 1ms, offset));
+    }
+
+    CHECK(x.earliest_deadline() == NOW);
+
+    const unsigned int expected[] = {0, 1, 2, 3, 4, 5, 7, 9, 12, 30};
+
+    for (const auto offset : expected) {
+      test_queue::time_point deadline;
+
+      const auto result = x.pop(deadline);
+      REQUIRE(result.has_value());
+      CHECK(result.value() == offset);
+      CHECK(deadline == NOW + offset * 1ms);
+    }
+
+    CHECK_FALSE(x.pop().has_value());
+    CHECK_FALSE(x.earliest_deadline().has_value());
+  }
+
+  TEST_CASE("Popping equal deadlines in FIFO order") {
+    test_queue x;
+
+    for (unsigned int i = 0; i < 10; i++) {
+      REQUIRE(x.push(NOW, i));
+    }
+
+    for (unsigned int i = 0; i < 10; i++) {
+      const auto result = x.pop();
+      REQUIRE(result.has_value());
+      CHECK(result.value() == i);
+    }
+  }
+
+  TEST_CASE("Pushing an earlier deadline than popped before") {
+    test_queue x{1ms};
+
+    REQUIRE(x.push(NOW + 10ms, 10u));
+    REQUIRE(x.push(NOW + 20ms, 20u));
+
+    CHECK(x.pop() == 10u);
+
+    REQUIRE(x.push(NOW - 5ms, 0u));
+
+    CHECK(x.earliest_deadline() == NOW - 5ms);
+    CHECK(x.pop() == 0u);
+    CHECK(x.earliest_deadline() == NOW + 20ms);
+    CHECK(x.pop() == 20u);
+  }
+
+  TEST_CASE("Move-only type handling") {
+    deadline_queue<move_only, 3> x;
+
+    CHECK(x.push(NOW, move_only{}));
+    CHECK(x.push(NOW + 1s, move_only{}));
+    CHECK(x.push(NOW - 1s, move_only{}));
+
+    const auto pop = [&] {
+      auto element = x.pop();
+      REQUIRE(element.has_value());
+      [[maybe_unused]] const move_only m = std::move(element.value());
+    };
+
+    pop();
+    pop();
+    pop();
+  }
+
+  TEST_CASE("Flushing the queue") {
+    test_queue x;
+
+    for (unsigned int i = 0; i < 10; i++) {
+      REQUIRE(x.push(NOW + i * 1ms, i));
+    }
+
+    REQUIRE(x.size() == 10);
+
+    CHECK(x.flush() == 10);
+
+    CHECK(x.empty());
+    CHECK_FALSE(x.earliest_deadline().has_value());
+    CHECK(x.flush() == 0);
+  }
+
+} // TEST_SUITE
@@ -0,0 +1,76 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "../source/executor_context.hpp"
+
+#include <doctest/doctest.h>
+
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+using namespace ts;
+
+TEST_SUITE("executor_context") {
+  TEST_CASE("Construction") {
+    executor_context c{3};
+
+    CHECK(c.id() == 3);
+  }
+
+  TEST_CASE("Allocating from the arena") {
+    executor_context c{0, 1'024};
+
+    auto&      arena  = c.arena();
+    auto*      first  = arena.allocate(100);
+    auto*      second = arena.allocate(100);
+    const auto offset = static_cast<char*>(second) - static_cast<char*>(first);
+
+    CHECK(&c.arena() == &arena);
+    CHECK(offset >= 100);
+    CHECK(offset < 200);
+
+    // Exceeding the initial buffer grows the arena.
+    CHECK(arena.allocate(4'096) != nullptr);
+
+    c.reset_arena();
+
+    CHECK(arena.allocate(100) == first);
+  }
+
+  TEST_CASE("Using the arena with pmr containers") {
+    executor_context c{0};
+
+    {
+      std::pmr::vector<int> v{&c.arena()};
+
+      for (int i = 0; i < 1'000; i++) {
+        v.push_back(i);
+      }
+
+      CHECK(v.size() == 1'000);
+    }
+
+    c.reset_arena();
+  }
+
+  TEST_CASE("Resetting an unused arena") {
+    executor_context c{0};
+
+    CHECK_NOTHROW(c.reset_arena());
+  }
+
+  TEST_CASE("Scratch objects") {
+    executor_context c{0};
+
+    auto& buffer = c.scratch<std::vector<int>>();
+    buffer.push_back(42);
+
+    CHECK(&c.scratch<std::vector<int>>() == &buffer);
+    CHECK(c.scratch<std::vector<int>>().size() == 1);
+    CHECK(c.scratch<std::string>().empty());
+
+    c.reset_arena(); // Scratch objects are kept.
+
+    CHECK(c.scratch<std::vector<int>>().size() == 1);
+  }
+
+} // TEST_SUITE
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+
 #include "tracer.hpp"
 
 namespace helpers {
@@ -18,4 +22,33 @@ public:
   }
 };
 
+// Memory resource counting the allocations it forwards to the default resource.
+class counting_resource final : public std::pmr::memory_resource {
+  std::atomic<std::size_t> allocations_{};
+  std::atomic<std::size_t> deallocations_{};
+
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    allocations_++;
+    return std::pmr::get_default_resource()->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override {
+    deallocations_++;
+    std::pmr::get_default_resource()->deallocate(pointer, bytes, alignment);
+  }
+
+  [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    return (this == &other);
+  }
+
+public:
+  [[nodiscard]] std::size_t allocations() const noexcept {
+    return allocations_;
+  }
+
+  [[nodiscard]] std::size_t deallocations() const noexcept {
+    return deallocations_;
+  }
+};
+
 } // namespace helpers
@@ -0,0 +1,108 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "../source/histogram.hpp"
+
+#include <doctest/doctest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+using namespace ts;
+using namespace std::chrono_literals;
+
+TEST_SUITE("latency_histogram") {
+  TEST_CASE("Bucket mapping") {
+    for (std::uint64_t value = 0; value < latency_histogram::SUB_BUCKETS; value++) {
+      CHECK(latency_histogram::bucket_index(value) == value);
+      CHECK(latency_histogram::bucket_upper_bound(latency_histogram::bucket_index(value)) == value);
+    }
+
+    // Every value must map onto a bucket whose upper bound is not smaller, within the relative error bound.
+    for (std::uint64_t value = 1; value < (std::uint64_t{1} << 62); value = (value * 3) + 1) {
+      const auto index       = latency_histogram::bucket_index(value);
+      const auto upper_bound = latency_histogram::bucket_upper_bound(index);
+
+      REQUIRE(index < latency_histogram::NUM_BUCKETS);
+      CHECK(upper_bound >= value);
+      CHECK((upper_bound - value) <= (value / latency_histogram::SUB_BUCKETS));
+    }
+
+    CHECK(latency_histogram::bucket_index(std::numeric_limits<std::uint64_t>::max())
+          == latency_histogram::NUM_BUCKETS - 1);
+  }
+
+  TEST_CASE("Empty histogram") {
+    latency_histogram h;
+
+    CHECK(h.count() == 0);
+    CHECK(h.percentile(50) == 0ns);
+    CHECK(h.max() == 0ns);
+  }
+
+  TEST_CASE("Percentiles") {
+    latency_histogram h;
+
+    for (int i = 1; i <= 1'000; i++) {
+      h.record(std::chrono::microseconds{i});
+    }
+
+    CHECK(h.count() == 1'000);
+
+    const auto check_near = [](std::chrono::nanoseconds value, std::chrono::nanoseconds expected) {
+      CHECK(value >= expected);
+      CHECK(value <= expected + (expected / latency_histogram::SUB_BUCKETS));
+    };
+
+    check_near(h.percentile(0), 1us);
+    check_near(h.percentile(50), 500us);
+    check_near(h.percentile(99), 990us);
+    check_near(h.percentile(99.9), 999us);
+    check_near(h.percentile(100), 1'000us);
+    check_near(h.max(), 1'000us);
+  }
+
+  TEST_CASE("Percentiles (failure cases)") {
+    latency_histogram h;
+
+    CHECK_THROWS_AS((void)h.percentile(-1), std::out_of_range);
+    CHECK_THROWS_AS((void)h.percentile(100.1), std::out_of_range);
+  }
+
+  TEST_CASE("Negative values") {
+    latency_histogram h;
+
+    h.record(-5ns);
+
+    CHECK(h.count() == 1);
+    CHECK(h.max() == 0ns);
+  }
+
+  TEST_CASE("Merging") {
+    latency_histogram h1, h2;
+
+    h1.record(1ms);
+    h2.record(2ms);
+    h2.record(3ms);
+
+    h1 += h2;
+
+    CHECK(h1.count() == 3);
+    CHECK(h1.percentile(100) >= 3ms);
+  }
+
+  TEST_CASE("Atomic histogram snapshot") {
+    detail::atomic_latency_histogram h;
+
+    h.record(10ns);
+    h.record(10ns);
+    h.record(1s);
+
+    const auto snapshot = h.snapshot();
+
+    CHECK(snapshot.count() == 3);
+    CHECK(snapshot.percentile(50) == 10ns);
+    CHECK(snapshot.max() >= 1s);
+  }
+
+} // TEST_SUITE
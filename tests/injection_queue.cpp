@@ -0,0 +1,90 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "../source/injection_queue.hpp"
+
+#include <doctest/doctest.h>
+
+#include <utility>
+#include <vector>
+
+struct move_only {
+  move_only() = default;
+
+  move_only(move_only&&)            = default;
+  move_only& operator=(move_only&&) = default;
+};
+
+using namespace ts;
+
+using test_queue = injection_queue<unsigned int>;
+
+TEST_SUITE("injection_queue") {
+  TEST_CASE("Cache line alignment") {
+    CHECK(alignof(test_queue) == cache_line_size);
+    CHECK(sizeof(test_queue) % cache_line_size == 0);
+  }
+
+  TEST_CASE("Pushing and popping elements") {
+    test_queue x;
+
+    CHECK(x.empty());
+    CHECK_FALSE(x.pop().has_value());
+
+    // The queue is unbounded.
+    for (unsigned int i = 0; i < 10'000; i++) {
+      x.push(i);
+    }
+
+    CHECK(x.size() == 10'000);
+
+    for (unsigned int i = 0; i < 10'000; i++) {
+      const auto result = x.pop();
+      REQUIRE(result.has_value());
+      CHECK(result.value() == i);
+    }
+
+    CHECK(x.empty());
+    CHECK_FALSE(x.pop().has_value());
+  }
+
+  TEST_CASE("Pushing and popping elements in bulk") {
+    test_queue x;
+
+    x.push(0u);
+    x.push_bulk({1, 2, 3});
+    x.push_bulk({});
+
+    CHECK(x.size() == 4);
+
+    CHECK(x.pop_bulk(3) == std::vector<unsigned int>{0, 1, 2});
+    CHECK(x.pop_bulk(3) == std::vector<unsigned int>{3});
+    CHECK(x.pop_bulk(3).empty());
+    CHECK(x.empty());
+  }
+
+  TEST_CASE("Move-only type handling") {
+    injection_queue<move_only> x;
+
+    x.push(move_only{});
+
+    std::vector<move_only> elements;
+    elements.emplace_back();
+    elements.emplace_back();
+
+    x.push_bulk(std::move(elements));
+
+    CHECK(x.size() == 3);
+    CHECK(x.pop().has_value());
+    CHECK(x.pop_bulk(2).size() == 2);
+  }
+
+  TEST_CASE("Flushing the queue") {
+    test_queue x;
+
+    x.push_bulk({1, 2, 3});
+
+    CHECK(x.flush() == 3);
+    CHECK(x.empty());
+    CHECK(x.flush() == 0);
+  }
+
+} // TEST_SUITE
@@ -0,0 +1,176 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "../source/metrics.hpp"
+
+#include <doctest/doctest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "../source/simple_scheduler.hpp"
+
+using namespace ts;
+using namespace std::chrono_literals;
+
+static_assert(metrics_enabled, "Metrics tests must be compiled with TS_ENABLE_METRICS");
+
+const auto NUM_CORES = std::thread::hardware_concurrency();
+
+TEST_SUITE("metrics") {
+  TEST_CASE("Executor counters") {
+    detail::executor_counters c;
+
+    c.count_pop(true, false);
+    c.count_pop(true, true);
+    c.count_pop(false, false);
+    c.count_task();
+    c.count_task();
+    c.count_busy(10ns);
+    c.count_busy(20ns);
+    c.count_park();
+    c.count_unpark(5ns);
+    c.count_queue_delay(3ns);
+    c.count_execution_time(7ns);
+    c.count_execution_time(9ns);
+    c.count_deadline_miss();
+
+    const auto m = c.snapshot();
+
+    CHECK(m.tasks_executed == 2);
+    CHECK(m.steals == 1);
+    CHECK(m.failed_steals == 1);
+    CHECK(m.parks == 1);
+    CHECK(m.unparks == 1);
+    CHECK(m.busy_time == 30ns);
+    CHECK(m.idle_time == 5ns);
+    CHECK(m.queue_delay.count() == 1);
+    CHECK(m.queue_delay.max() == 3ns);
+    CHECK(m.execution_time.count() == 2);
+    CHECK(m.execution_time.percentile(50) == 7ns);
+    CHECK(m.deadline_misses == 1);
+  }
+
+  TEST_CASE("Executor counters alignment") {
+    CHECK(alignof(detail::executor_counters) == cache_line_size);
+    CHECK(sizeof(detail::executor_counters) % cache_line_size == 0);
+  }
+
+  TEST_CASE("Accumulating executor metrics") {
+    scheduler_metrics m;
+    m.executors.push_back({1, 2, 3, 4, 5, 6ns, 7ns, 8, {}, {}});
+    m.executors.push_back({10, 20, 30, 40, 50, 60ns, 70ns, 80, {}, {}});
+    m.executors[0].queue_delay.record(1ns);
+    m.executors[1].queue_delay.record(2ns);
+
+    const auto total = m.total();
+
+    CHECK(total.tasks_executed == 11);
+    CHECK(total.steals == 22);
+    CHECK(total.failed_steals == 33);
+    CHECK(total.parks == 44);
+    CHECK(total.unparks == 55);
+    CHECK(total.busy_time == 66ns);
+    CHECK(total.idle_time == 77ns);
+    CHECK(total.queue_depth == 88);
+    CHECK(total.queue_delay.count() == 2);
+    CHECK(total.queue_delay.max() == 2ns);
+  }
+
+  TEST_CASE("Scheduler metrics" * doctest::timeout(1)) {
+    simple_scheduler<1> s{1};
+
+    REQUIRE(s.metrics().executors.size() == 1);
+
+    std::atomic<bool> started = false;
+    std::atomic<bool> release = false;
+
+    auto blocker = s.schedule([&] {
+      started = true;
+      while (!release) {
+        std::this_thread::sleep_for(1ms);
+      }
+    });
+
+    REQUIRE(blocker);
+
+    while (!started) {
+      std::this_thread::yield();
+    }
+
+    auto queued = s.schedule([] {});
+
+    REQUIRE(queued);
+    CHECK(s.metrics().injection_queue_depth == 1);
+
+    const auto deadline = std::chrono::steady_clock::now() + 1s;
+
+    auto urgent = s.schedule([] {}, deadline);
+
+    REQUIRE(urgent);
+    CHECK(s.metrics().executors[0].queue_depth == 1);
+
+    CHECK_FALSE(s.schedule([] {}, deadline));
+    CHECK(s.metrics().schedule_rejections == 1);
+
+    release = true;
+    blocker->wait();
+    queued->wait();
+    urgent->wait();
+
+    // Wait until the executor has accounted for the last task.
+    while (s.metrics().total().tasks_executed < 3) {
+      std::this_thread::yield();
+    }
+
+    const auto m = s.metrics().total();
+
+    CHECK(m.tasks_executed == 3);
+    CHECK(m.steals == 0);
+    CHECK(m.queue_depth == 0);
+    CHECK(m.deadline_misses == 0);
+    CHECK(m.busy_time > 0ns);
+
+    // The queued task waited at least for the blocker to be released.
+    CHECK(m.queue_delay.count() == 3);
+    CHECK(m.queue_delay.max() >= 1ms);
+    CHECK(m.execution_time.count() == 3);
+    CHECK(m.execution_time.max() >= 1ms);
+    CHECK(m.execution_time.percentile(50) < 1ms);
+  }
+
+  TEST_CASE("Queue depth with executor affinity" * doctest::skip(NUM_CORES < 2) * doctest::timeout(1)) {
+    simple_scheduler<4> s{2};
+
+    std::atomic<int>  started = 0;
+    std::atomic<bool> release = false;
+
+    // Hold both executors, so the placed tasks remain queued.
+    for (int i = 0; i < 2; i++) {
+      (void)s.schedule([&] {
+        started++;
+        release.wait(false);
+      });
+    }
+
+    while (started < 2) {
+      std::this_thread::yield();
+    }
+
+    for (int i = 0; i < 3; i++) {
+      (void)s.schedule_on(1, [] {});
+    }
+
+    (void)s.schedule_keyed(4, [] {}, [](int key) { return static_cast<std::size_t>(key); });
+
+    const auto m = s.metrics();
+
+    CHECK(m.executors[0].queue_depth == 1);
+    CHECK(m.executors[1].queue_depth == 3);
+    CHECK(m.injection_queue_depth == 0);
+
+    release = true;
+    release.notify_all();
+    s.wait_idle();
+  }
+
+} // TEST_SUITE
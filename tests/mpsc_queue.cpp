@@ -0,0 +1,214 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "../source/mpsc_queue.hpp"
+
+#include <doctest/doctest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../source/pool_resource.hpp"
+
+#include "helpers.hpp"
+
+// Element type that blocks when moved while armed, until released.
+struct blocking_move {
+  static inline std::atomic<bool> armed    = false;
+  static inline std::atomic<bool> moving   = false;
+  static inline std::atomic<bool> released = false;
+
+  blocking_move() = default;
+
+  blocking_move(blocking_move&&) noexcept {
+    if (armed) {
+      moving = true;
+      moving.notify_all();
+      released.wait(false);
+    }
+  }
+
+  blocking_move& operator=(blocking_move&&) = default;
+};
+
+using namespace ts;
+
+using test_queue = mpsc_queue<unsigned int, 10>;
+
+TEST_SUITE("mpsc_queue") {
+  TEST_CASE("Default construction") {
+    test_queue x;
+
+    REQUIRE(x.max_size() == 10);
+    CHECK(x.empty());
+  }
+
+  TEST_CASE("Construction with a memory resource") {
+    helpers::counting_resource resource;
+
+    {
+      test_queue x{&resource};
+
+      REQUIRE(x.push(42u));
+      REQUIRE(x.push(43u));
+      CHECK(resource.allocations() == 3); // Including the stub node.
+    }
+
+    CHECK(resource.deallocations() == resource.allocations());
+  }
+
+  TEST_CASE("Cache line alignment") {
+    CHECK(alignof(test_queue) == cache_line_size);
+    CHECK(sizeof(test_queue) % cache_line_size == 0);
+  }
+
+  TEST_CASE("Pushing elements") {
+    test_queue x;
+
+    for (unsigned int i = 0; i < 10; i++) {
+      REQUIRE(x.size() == i);
+      CHECK(x.push(42u));
+    }
+
+    REQUIRE(x.size() == 10);
+
+    CHECK_FALSE(x.push(42u));
+    CHECK_FALSE(x.push(42u));
+
+    REQUIRE(x.size() == 10);
+  }
+
+  TEST_CASE("Popping elements") {
+    test_queue x;
+
+    for (unsigned int i = 0; i < 10; i++) {
+      REQUIRE(x.push(i));
+    }
+
+    for (unsigned int i = 0; i < 10; i++) {
+      const auto result = (i % 2 == 0) ? x.pop() : x.try_pop();
+      CHECK(result.has_value());
+      CHECK(result.value() == i);
+    }
+
+    CHECK(x.empty());
+    CHECK_FALSE(x.pop().has_value());
+    CHECK_FALSE(x.try_pop().has_value());
+  }
+
+  TEST_CASE("Popping elements in bulk") {
+    test_queue x;
+
+    for (unsigned int i = 0; i < 5; i++) {
+      REQUIRE(x.push(i));
+    }
+
+    CHECK(x.pop_bulk(0).empty());
+    CHECK(x.pop_bulk(2) == std::vector<unsigned int>{0, 1});
+    CHECK(x.size() == 3);
+    CHECK(x.pop_bulk(10) == std::vector<unsigned int>{2, 3, 4});
+    CHECK(x.empty());
+  }
+
+  TEST_CASE("Rejected elements are left untouched") {
+    mpsc_queue<std::unique_ptr<int>, 1> x;
+
+    auto element = std::make_unique<int>(42);
+
+    REQUIRE(x.push(std::make_unique<int>(0)));
+    CHECK_FALSE(x.push(std::move(element)));
+    CHECK(element != nullptr);
+  }
+
+  TEST_CASE("Destroying a non-empty queue") {
+    helpers::counting_resource resource;
+
+    {
+      mpsc_queue<std::unique_ptr<int>, 10> x{&resource};
+
+      REQUIRE(x.push(std::make_unique<int>(1)));
+      REQUIRE(x.push(std::make_unique<int>(2)));
+    }
+
+    CHECK(resource.deallocations() == resource.allocations());
+  }
+
+  TEST_CASE("Flushing the queue") {
+    test_queue x;
+
+    for (unsigned int i = 0; i < 10; i++) {
+      REQUIRE(x.push(i));
+    }
+
+    CHECK(x.flush() == 10);
+    CHECK(x.empty());
+    CHECK_FALSE(x.pop().has_value());
+    CHECK(x.push(42u));
+  }
+
+  TEST_CASE("Skipping a queue that is being consumed" * doctest::timeout(1)) {
+    mpsc_queue<blocking_move, 10> x;
+
+    REQUIRE(x.push(blocking_move{}));
+    REQUIRE(x.push(blocking_move{}));
+
+    // The consumer lock is held while the popped element is moved out of the queue.
+    blocking_move::armed = true;
+
+    std::jthread consumer{[&] { CHECK(x.pop().has_value()); }};
+
+    blocking_move::moving.wait(false);
+
+    CHECK_FALSE(x.try_pop().has_value());
+    CHECK(x.size() == 2);
+
+    blocking_move::armed    = false;
+    blocking_move::released = true;
+    blocking_move::released.notify_all();
+    consumer.join();
+
+    CHECK(x.try_pop().has_value());
+  }
+
+  TEST_CASE("Concurrent producers") {
+    pool_resource                   pool;
+    mpsc_queue<std::uint64_t, 8192> x{&pool};
+
+    constexpr std::uint64_t num_producers = 4;
+    constexpr std::uint64_t num_elements  = 2'000;
+
+    std::vector<std::jthread> producers;
+
+    for (std::uint64_t p = 0; p < num_producers; p++) {
+      producers.emplace_back([&, p] {
+        for (std::uint64_t i = 0; i < num_elements; i++) {
+          REQUIRE(x.push((p << 32) | i));
+        }
+      });
+    }
+
+    // Elements of a single producer are popped in their push order.
+    std::vector<std::uint64_t> next(num_producers);
+    std::uint64_t              count = 0;
+
+    while (count < (num_producers * num_elements)) {
+      const auto element = (count % 2 == 0) ? x.pop() : x.try_pop();
+
+      if (!element) {
+        std::this_thread::yield();
+        continue;
+      }
+
+      const auto producer = *element >> 32;
+      REQUIRE(producer < num_producers);
+      CHECK((*element & 0xffff'ffff) == next[producer]);
+      next[producer]++;
+      count++;
+    }
+
+    CHECK(x.empty());
+  }
+
+} // TEST_SUITE
@@ -3,8 +3,16 @@
 
 #include <doctest/doctest.h>
 
+#include <atomic>
+#include <memory>
 #include <stdexcept>
+#include <thread>
 #include <utility>
+#include <vector>
+
+#include "../source/mpsc_queue.hpp"
+
+#include "helpers.hpp"
 
 using namespace ts;
 
@@ -19,6 +27,25 @@ TEST_SUITE("multiqueue") {
   TEST_CASE("Construction (failure cases)") {
     CHECK_THROWS_AS(test_queue{0}, std::underflow_error);
     CHECK_THROWS_AS(test_queue{10'000}, std::overflow_error);
+    CHECK_THROWS_AS((test_queue{2, {0}}), std::invalid_argument);
+    CHECK_THROWS_AS((test_queue{2, {0, 0, 1}}), std::invalid_argument);
+  }
+
+  TEST_CASE("Construction with a memory resource") {
+    helpers::counting_resource resource;
+
+    {
+      test_queue x1{std::allocator_arg, &resource, 2};
+      test_queue x2{std::allocator_arg, &resource, 2, {0, 1}};
+
+      REQUIRE(x1.push(42u));
+      REQUIRE(x2.push(42u));
+      CHECK(resource.allocations() > 0);
+
+      CHECK_THROWS_AS((test_queue{std::allocator_arg, &resource, 2, {0}}), std::invalid_argument);
+    }
+
+    CHECK(resource.deallocations() == resource.allocations());
   }
 
   TEST_CASE("Move construction") {
@@ -48,6 +75,12 @@ TEST_SUITE("multiqueue") {
     CHECK(multiqueue<int, 10>{1}.max_queue_size() == 10);
   }
 
+  TEST_CASE("Getting the maximum number of queues") {
+    CHECK(test_queue::max_num_queues() == 1'024);
+    CHECK_NOTHROW(test_queue{test_queue::max_num_queues()});
+    CHECK_THROWS_AS(test_queue{test_queue::max_num_queues() + 1}, std::overflow_error);
+  }
+
   TEST_CASE("Getting the number of queues") {
     CHECK(multiqueue<int, 1>{1}.num_queues() == 1);
     CHECK(multiqueue<int, 1>{2}.num_queues() == 2);
@@ -98,6 +131,37 @@ TEST_SUITE("multiqueue") {
     }
   }
 
+  TEST_CASE("Getting the approximate size and empty state") {
+    test_queue x{4};
+
+    CHECK(x.approximate_empty());
+    CHECK(x.approximate_size() == 0);
+
+    for (unsigned int i = 0; i < x.max_capacity(); i++) {
+      REQUIRE(x.push(i));
+      CHECK(x.approximate_size() == (i + 1));
+    }
+
+    REQUIRE_FALSE(x.push(42u));
+    CHECK(x.approximate_size() == x.max_capacity());
+
+    REQUIRE(x.pop(0).has_value());
+    REQUIRE(x.pop(3).has_value());
+    CHECK(x.approximate_size() == x.max_capacity() - 2);
+    CHECK(x.approximate_size() == x.size());
+
+    x.flush();
+
+    CHECK(x.approximate_empty());
+    CHECK(x.approximate_size() == 0);
+
+    REQUIRE(x.push(2, 42u));
+    CHECK(x.approximate_size() == 1);
+    REQUIRE(x.pop(0).has_value());
+    REQUIRE_FALSE(x.pop(0).has_value());
+    CHECK(x.approximate_empty());
+  }
+
   TEST_CASE("Pushing elements (single queue)") {
     test_queue x{1};
 
@@ -124,6 +188,33 @@ TEST_SUITE("multiqueue") {
     CHECK_FALSE(x.push(42u));
   }
 
+  TEST_CASE("Pushing elements queue-indexed") {
+    test_queue x{2};
+
+    for (unsigned int i = 0; i < x.max_queue_size(); i++) {
+      CHECK(x.push(1, i));
+    }
+
+    CHECK_FALSE(x.push(1, 42u));
+    CHECK(x.size() == x.max_queue_size());
+
+    // The first queue is empty, so popping from it should steal in order from the second queue.
+    for (unsigned int i = 0; i < x.max_queue_size(); i++) {
+      const auto element = x.pop(0);
+      REQUIRE(element.has_value());
+      CHECK(element.value() == i);
+    }
+
+    CHECK(x.empty());
+  }
+
+  TEST_CASE("Pushing queue-indexed (failure cases)") {
+    const auto push = [](auto&& queue, unsigned int index) { [[maybe_unused]] auto result = queue.push(index, 42u); };
+
+    CHECK_THROWS_AS(push(test_queue{1}, 1), std::out_of_range);
+    CHECK_THROWS_AS(push(test_queue{10}, 10), std::out_of_range);
+  }
+
   TEST_CASE("Popping elements queue-indexed (single queue)") {
     test_queue x{1};
 
@@ -206,6 +297,190 @@ TEST_SUITE("multiqueue") {
     CHECK_FALSE(x.pop(1).has_value());
   }
 
+  TEST_CASE("Popping elements with work stealing (intrusive queues)") {
+    multiqueue<unsigned int, 5, mpsc_queue<unsigned int, 5>> x{2};
+
+    for (unsigned int i = 0; i < (2 * x.max_queue_size()); i++) {
+      REQUIRE(x.push(i));
+    }
+
+    CHECK_FALSE(x.push(10u));
+
+    for (unsigned int i = 1; i < 10; i += 2) {
+      CHECK(x.pop(1) == i);
+    }
+
+    bool stolen = false;
+
+    for (unsigned int i = 0; i < 10; i += 2) {
+      CHECK(x.pop(1, stolen) == i);
+      CHECK(stolen);
+    }
+
+    CHECK(x.approximate_empty());
+    CHECK_FALSE(x.pop(0).has_value());
+  }
+
+  TEST_CASE("Popping elements with work stealing (many queues)") {
+    test_queue x{test_queue::max_num_queues()};
+
+    REQUIRE(x.push(1000, 1000u));
+    REQUIRE(x.push(3, 3u));
+    REQUIRE(x.push(70, 70u));
+
+    // Victims are visited round-robin, starting after the indexed queue and wrapping around.
+    CHECK(x.pop(0) == 3u);
+    CHECK(x.pop(100) == 1000u);
+    CHECK(x.pop(1010) == 70u);
+    CHECK_FALSE(x.pop(0).has_value());
+
+    // Drained queues are no longer visited, but become victims again when pushed to.
+    REQUIRE(x.push(3, 3u));
+    CHECK(x.pop(1023) == 3u);
+    CHECK(x.approximate_empty());
+  }
+
+  TEST_CASE("Concurrent pushing and work stealing" * doctest::timeout(10)) {
+    multiqueue<unsigned int, 8> x{256};
+
+    constexpr unsigned int num_elements = 20'000;
+
+    std::atomic<unsigned int> popped = 0;
+
+    const auto consume = [&](std::size_t index) {
+      while (popped < num_elements) {
+        if (x.pop(index)) {
+          popped++;
+        }
+      }
+    };
+
+    {
+      std::jthread consumer1{consume, 0};
+      std::jthread consumer2{consume, 130};
+
+      for (unsigned int i = 0; i < num_elements; i++) {
+        while (!x.push(i)) {
+          std::this_thread::yield();
+        }
+      }
+    }
+
+    CHECK(popped == num_elements);
+    CHECK(x.empty());
+  }
+
+  TEST_CASE("Popping elements with grouped work stealing") {
+    test_queue x{4, {0, 1, 1, 0}};
+
+    REQUIRE(x.push(1, 1u));
+    REQUIRE(x.push(3, 3u));
+
+    // Queue 0 is empty: queue 1 is the next in order, but queue 3 is in the same group as queue 0.
+    const auto element0 = x.pop(0);
+    REQUIRE(element0.has_value());
+    CHECK(element0.value() == 3);
+
+    // No work is left in group 0, so work is stolen across groups.
+    const auto element1 = x.pop(0);
+    REQUIRE(element1.has_value());
+    CHECK(element1.value() == 1);
+
+    CHECK_FALSE(x.pop(0).has_value());
+  }
+
+  TEST_CASE("Popping elements without work stealing") {
+    test_queue x{2};
+
+    REQUIRE(x.push(1, 1u));
+    REQUIRE(x.push(1, 2u));
+    REQUIRE(x.push(1, 3u));
+
+    CHECK_FALSE(x.pop_local(0).has_value());
+    CHECK(x.pop_local(1) == 1u);
+    CHECK(x.approximate_size() == 2);
+
+    const auto elements = x.pop_bulk(1, 10);
+
+    CHECK(elements == std::vector<unsigned int>{2, 3});
+    CHECK(x.approximate_empty());
+    CHECK(x.pop_bulk(0, 10).empty());
+
+    CHECK_THROWS_AS((void)x.pop_local(2), std::out_of_range);
+    CHECK_THROWS_AS((void)x.pop_bulk(2, 1), std::out_of_range);
+  }
+
+  TEST_CASE("Pushing elements to active queues") {
+    test_queue x{4};
+
+    REQUIRE(x.num_active_queues() == 4);
+
+    x.set_num_active_queues(2);
+
+    CHECK(x.num_active_queues() == 2);
+
+    for (unsigned int i = 0; i < 8; i++) {
+      REQUIRE(x.push(i));
+    }
+
+    CHECK(x.queue_size(0) == 4);
+    CHECK(x.queue_size(1) == 4);
+    CHECK(x.queue_size(2) == 0);
+    CHECK(x.queue_size(3) == 0);
+
+    // Indexed pushes to inactive queues are allowed, and the elements can be stolen.
+    REQUIRE(x.push(3, 8u));
+
+    for (unsigned int i = 0; i < 9; i++) {
+      CHECK(x.pop(0).has_value());
+    }
+
+    CHECK(x.empty());
+  }
+
+  TEST_CASE("Setting the number of active queues (failure cases)") {
+    test_queue x{4};
+
+    CHECK_THROWS_AS(x.set_num_active_queues(0), std::underflow_error);
+    CHECK_THROWS_AS(x.set_num_active_queues(5), std::out_of_range);
+  }
+
+  TEST_CASE("Migrating elements from inactive queues") {
+    multiqueue<unsigned int, 5> x{3};
+
+    for (unsigned int i = 0; i < 5; i++) {
+      REQUIRE(x.push(2, i));
+    }
+
+    x.set_num_active_queues(2);
+
+    CHECK(x.migrate(2) == 5);
+    CHECK(x.queue_size(0) + x.queue_size(1) == 5);
+    CHECK(x.queue_size(2) == 0);
+    CHECK(x.approximate_size() == 5);
+
+    // Fill up the active queues: elements that cannot be moved remain in place.
+    for (unsigned int i = 0; i < 5; i++) {
+      REQUIRE(x.push(2, i));
+    }
+
+    CHECK(x.migrate(2) == 5);
+    CHECK(x.queue_size(2) == 0);
+
+    REQUIRE(x.push(2, 0u));
+
+    CHECK(x.migrate(2) == 0);
+    CHECK(x.queue_size(2) == 1);
+    CHECK(x.size() == 11);
+  }
+
+  TEST_CASE("Migrating elements (failure cases)") {
+    test_queue x{4};
+
+    CHECK_THROWS_AS(x.migrate(4), std::out_of_range);
+    CHECK_THROWS_AS(x.migrate(3), std::invalid_argument);
+  }
+
   TEST_CASE("Flushing the queue") {
     multiqueue<unsigned int, 5> x{2};
 
@@ -218,7 +493,7 @@ TEST_SUITE("multiqueue") {
     REQUIRE_FALSE(x.empty());
     REQUIRE(x.size() == (2 * x.max_queue_size()));
 
-    x.flush();
+    CHECK(x.flush() == (2 * x.max_queue_size()));
 
     CHECK(x.empty());
     CHECK(x.size() == 0);
@@ -0,0 +1,178 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "../source/pool_resource.hpp"
+
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "helpers.hpp"
+
+using namespace ts;
+
+TEST_SUITE("pool_resource") {
+  TEST_CASE("Construction") {
+    helpers::counting_resource upstream;
+
+    {
+      pool_resource p{&upstream};
+
+      CHECK(p.upstream_resource() == &upstream);
+      CHECK(p.is_equal(p));
+      CHECK_FALSE(p.is_equal(upstream));
+    }
+
+    CHECK(upstream.allocations() == 0);
+  }
+
+  TEST_CASE("Reusing freed blocks") {
+    helpers::counting_resource upstream;
+
+    {
+      pool_resource p{&upstream};
+
+      auto* first = p.allocate(48);
+      p.deallocate(first, 48);
+
+      CHECK(p.allocate(64) == first); // Same size class.
+      CHECK(p.allocate(64) != first);
+      CHECK(upstream.allocations() == 1);
+    }
+
+    CHECK(upstream.deallocations() == 1);
+  }
+
+  TEST_CASE("Aligning blocks to their size class") {
+    pool_resource p;
+
+    for (std::size_t size = 1; size <= pool_resource::max_block_size; size *= 2) {
+      auto* block = p.allocate(size);
+      CHECK(reinterpret_cast<std::uintptr_t>(block) % std::max(size, pool_resource::min_block_size) == 0);
+      p.deallocate(block, size);
+    }
+
+    auto* aligned = p.allocate(8, 256);
+    CHECK(reinterpret_cast<std::uintptr_t>(aligned) % 256 == 0);
+    p.deallocate(aligned, 8, 256);
+  }
+
+  TEST_CASE("Forwarding large allocations") {
+    helpers::counting_resource upstream;
+    pool_resource              p{&upstream};
+
+    auto* large = p.allocate(pool_resource::max_block_size + 1);
+
+    CHECK(upstream.allocations() == 1);
+
+    p.deallocate(large, pool_resource::max_block_size + 1);
+
+    CHECK(upstream.deallocations() == 1);
+  }
+
+  TEST_CASE("Growing the pool") {
+    helpers::counting_resource upstream;
+    pool_resource              p{&upstream};
+    std::set<void*>            blocks;
+
+    // More blocks than fit in a single slab.
+    constexpr std::size_t count = 3 * pool_resource::slab_size / pool_resource::max_block_size;
+
+    for (std::size_t i = 0; i < count; i++) {
+      blocks.insert(p.allocate(pool_resource::max_block_size));
+    }
+
+    CHECK(blocks.size() == count);
+    CHECK(upstream.allocations() == 4);
+
+    for (auto* block : blocks) {
+      p.deallocate(block, pool_resource::max_block_size);
+    }
+
+    for (std::size_t i = 0; i < count; i++) {
+      CHECK(blocks.contains(p.allocate(pool_resource::max_block_size)));
+    }
+
+    CHECK(upstream.allocations() == 4);
+  }
+
+  TEST_CASE("Forwarding allocations when a size class is full") {
+    helpers::counting_resource upstream;
+
+    {
+      pool_resource      p{&upstream};
+      std::vector<void*> blocks;
+
+      // More blocks than fit in the maximum number of slabs of the size class.
+      constexpr std::size_t count = pool_resource::max_slabs * pool_resource::slab_size / pool_resource::max_block_size;
+
+      for (std::size_t i = 0; i < count; i++) {
+        blocks.push_back(p.allocate(pool_resource::max_block_size));
+      }
+
+      CHECK(upstream.allocations() > pool_resource::max_slabs);
+
+      for (auto* block : blocks) {
+        p.deallocate(block, pool_resource::max_block_size);
+      }
+
+      // The forwarded blocks are returned to the upstream resource, the slabs are kept until destruction.
+      CHECK(upstream.deallocations() == (upstream.allocations() - pool_resource::max_slabs));
+    }
+
+    CHECK(upstream.allocations() == upstream.deallocations());
+  }
+
+  TEST_CASE("Using the pool with pmr containers") {
+    pool_resource p;
+
+    std::pmr::vector<std::pmr::vector<int>> v{&p};
+
+    for (int i = 0; i < 100; i++) {
+      v.emplace_back(static_cast<std::size_t>(i % 10), i);
+    }
+
+    CHECK(v[42].size() == 2);
+    CHECK(v[42][1] == 42);
+  }
+
+  TEST_CASE("Concurrent allocation") {
+    pool_resource p;
+
+    const auto worker = [&](std::uint32_t id) {
+      std::vector<std::uint32_t*> blocks;
+
+      for (int round = 0; round < 100; round++) {
+        for (int i = 0; i < 100; i++) {
+          auto* block = static_cast<std::uint32_t*>(p.allocate(64));
+          *block      = id;
+          blocks.push_back(block);
+        }
+
+        // A block handed out twice would have been overwritten by another thread.
+        CHECK(std::ranges::all_of(blocks, [&](const auto* block) { return *block == id; }));
+
+        for (auto* block : blocks) {
+          p.deallocate(block, 64);
+        }
+
+        blocks.clear();
+      }
+    };
+
+    std::vector<std::thread> threads;
+
+    for (std::uint32_t id = 0; id < 4; id++) {
+      threads.emplace_back(worker, id);
+    }
+
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
+} // TEST_SUITE
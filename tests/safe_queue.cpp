@@ -3,7 +3,11 @@
 
 #include <doctest/doctest.h>
 
+#include <cstdint>
 #include <utility>
+#include <vector>
+
+#include "helpers.hpp"
 
 struct move_only {
   move_only() = default;
@@ -23,6 +27,29 @@ TEST_SUITE("safe_queue") {
     REQUIRE(x.max_size() == 10);
   }
 
+  TEST_CASE("Construction with a memory resource") {
+    helpers::counting_resource resource;
+
+    {
+      test_queue x{&resource};
+
+      REQUIRE(x.push(42u));
+      CHECK(resource.allocations() > 0);
+    }
+
+    CHECK(resource.deallocations() == resource.allocations());
+  }
+
+  TEST_CASE("Cache line alignment") {
+    CHECK(alignof(test_queue) == cache_line_size);
+    CHECK(sizeof(test_queue) % cache_line_size == 0);
+
+    test_queue queues[2];
+
+    const auto distance = reinterpret_cast<std::uintptr_t>(&queues[1]) - reinterpret_cast<std::uintptr_t>(&queues[0]);
+    CHECK(distance >= 2 * cache_line_size);
+  }
+
   TEST_CASE("Get maximum length") {
     CHECK(safe_queue<int, 1>{}.max_size() == 1);
     CHECK(safe_queue<int, 2>{}.max_size() == 2);
@@ -91,6 +118,20 @@ TEST_SUITE("safe_queue") {
     CHECK_FALSE(x.pop().has_value());
   }
 
+  TEST_CASE("Popping elements in bulk") {
+    test_queue x;
+
+    for (unsigned int i = 0; i < 5; i++) {
+      REQUIRE(x.push(i));
+    }
+
+    CHECK(x.pop_bulk(0).empty());
+    CHECK(x.pop_bulk(2) == std::vector<unsigned int>{0, 1});
+    CHECK(x.size() == 3);
+    CHECK(x.pop_bulk(10) == std::vector<unsigned int>{2, 3, 4});
+    CHECK(x.empty());
+  }
+
   TEST_CASE("Move-only type handling") {
     safe_queue<move_only, 3> x;
 
@@ -120,9 +161,10 @@ TEST_SUITE("safe_queue") {
     REQUIRE_FALSE(x.empty());
     REQUIRE(x.size() == 10);
 
-    x.flush();
+    CHECK(x.flush() == 10);
 
     CHECK(x.empty());
+    CHECK(x.flush() == 0);
   }
 
 } // TEST_SUITE
@@ -4,14 +4,28 @@
 #include <doctest/doctest.h>
 
 #include <algorithm>
+#include <array>
 #include <atomic>
 #include <chrono>
+#include <cstddef>
 #include <exception>
+#include <functional>
+#include <future>
 #include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <system_error>
 #include <thread>
 #include <utility>
+#include <vector>
 
+#include "../source/blocking.hpp"
+#include "../source/pool_resource.hpp"
 #include "../source/task.hpp"
+#include "../source/this_executor.hpp"
+#include "../source/topology.hpp"
+
+#include "helpers.hpp"
 
 using namespace ts;
 using namespace std::chrono_literals;
@@ -30,6 +44,73 @@ TEST_SUITE("simple_scheduler") {
     CHECK_THROWS_AS((simple_scheduler<10>{1024}), std::overflow_error);
   }
 
+  TEST_CASE("Construction with executor placement" * doctest::timeout(1)) {
+    simple_scheduler<10> s1{1, executor_placement{{0}, {}}};
+    simple_scheduler<10> s2{1, numa_placement(read_numa_topology())};
+
+    auto completion = s2.schedule([] {});
+
+    REQUIRE(completion);
+
+    completion->wait();
+  }
+
+  TEST_CASE("Construction with executor placement (failure cases)" * doctest::timeout(1)) {
+    CHECK_THROWS_AS((simple_scheduler<10>{1, executor_placement{{0, 1}, {0}}}), std::invalid_argument);
+    CHECK_THROWS_AS((simple_scheduler<10>{1, executor_placement{{100'000}, {}}}), std::system_error);
+  }
+
+  TEST_CASE("Construction with a memory resource" * doctest::timeout(1)) {
+    helpers::counting_resource upstream;
+
+    {
+      pool_resource        pool{&upstream};
+      simple_scheduler<10> s{std::allocator_arg, &pool, 1};
+      std::atomic<int>     counter = 0;
+
+      auto completion = s.schedule([&] { counter++; });
+
+      REQUIRE(completion);
+
+      completion->wait();
+
+      CHECK(counter == 1);
+      CHECK(upstream.allocations() > 0);
+    }
+
+    CHECK(upstream.allocations() == upstream.deallocations());
+  }
+
+  TEST_CASE("Scheduling with intrusive queues" * doctest::timeout(2)) {
+    simple_scheduler<16, queue_mode::intrusive> s{NUM_CORES};
+    std::atomic<int>                            calls = 0;
+
+    // Spawned tasks overflow the executor queue, spilling to the injection queue.
+    auto completion = s.schedule([&] {
+      std::vector<completion_token> completions;
+
+      for (int i = 0; i < 1'000; i++) {
+        completions.push_back(*s.schedule([&] { calls++; }));
+      }
+
+      for (const auto& c : completions) {
+        c.wait();
+      }
+    });
+
+    REQUIRE(completion);
+
+    for (std::size_t i = 0; i < s.num_executors(); i++) {
+      s.schedule_detached([&] { calls++; });
+      (void)s.schedule_on(i, [&] { calls++; });
+    }
+
+    completion->wait();
+    s.wait_idle();
+
+    CHECK(calls == 1'000 + 2 * static_cast<int>(s.num_executors()));
+  }
+
   TEST_CASE("Getting the number of executors") {
     CHECK(simple_scheduler<10>{1}.num_executors() == 1);
     CHECK(simple_scheduler<10>{NUM_CORES}.num_executors() == NUM_CORES);
@@ -174,4 +255,993 @@ TEST_SUITE("simple_scheduler") {
     }
   }
 
+  TEST_CASE("Waiting on nested tasks (caller-helps waiting)" * doctest::timeout(1)) {
+    simple_scheduler<16>      s{1};
+    std::atomic<unsigned int> count = 0;
+
+    auto parent = s.schedule([&] {
+      auto child0 = s.schedule([&] { count++; });
+      auto child1 = s.schedule([&] { count++; });
+
+      REQUIRE(child0);
+      REQUIRE(child1);
+
+      // With a single executor, this would deadlock if the executor did not process pending jobs while waiting.
+      child0->wait();
+      child1->wait();
+
+      count++;
+    });
+
+    REQUIRE(parent);
+
+    parent->wait();
+
+    CHECK(count == 3);
+    CHECK_FALSE(parent->exception().has_value());
+  }
+
+  TEST_CASE("Spawning from outside an executor") {
+    CHECK_FALSE(this_executor::is_executor());
+    CHECK_THROWS_AS((void)this_executor::spawn([] {}), std::logic_error);
+  }
+
+  TEST_CASE("Spawning nested tasks (fork-join)" * doctest::timeout(1)) {
+    simple_scheduler<16>      s{1};
+    std::atomic<unsigned int> count = 0;
+
+    const auto fork_join = [&](auto&& self, unsigned int depth) -> void {
+      count++;
+
+      if (depth == 0) {
+        return;
+      }
+
+      auto left  = this_executor::spawn([&] { self(self, depth - 1); });
+      auto right = this_executor::spawn([&] { self(self, depth - 1); });
+
+      REQUIRE(left);
+      REQUIRE(right);
+
+      left->wait();
+      right->wait();
+    };
+
+    auto root = s.schedule([&] {
+      CHECK(this_executor::is_executor());
+      fork_join(fork_join, 4);
+    });
+
+    REQUIRE(root);
+
+    root->wait();
+
+    CHECK(count == 31);
+    CHECK_FALSE(root->exception().has_value());
+  }
+
+  TEST_CASE("Cancelling queued tasks" * doctest::timeout(1)) {
+    simple_scheduler<16> s{1};
+    std::atomic<bool>    released = false;
+    std::atomic<bool>    called   = false;
+
+    auto blocker = s.schedule([&] { released.wait(false); });
+    auto victim  = s.schedule([&] { called = true; });
+
+    REQUIRE(blocker);
+    REQUIRE(victim);
+
+    CHECK(victim->request_stop());
+
+    released = true;
+    released.notify_one();
+
+    victim->wait();
+
+    CHECK(*victim);
+    CHECK(victim->cancelled());
+    CHECK_FALSE(called);
+    CHECK_FALSE(victim->exception().has_value());
+
+    blocker->wait();
+
+    CHECK_FALSE(blocker->cancelled());
+  }
+
+  TEST_CASE("Cancelling running tasks" * doctest::timeout(1)) {
+    simple_scheduler<16> s{1};
+    std::atomic<bool>    started = false;
+
+    auto completion = s.schedule([&](std::stop_token stop_token) {
+      started = true;
+      started.notify_one();
+
+      while (!stop_token.stop_requested()) {
+        std::this_thread::yield();
+      }
+    });
+
+    REQUIRE(completion);
+
+    started.wait(false);
+
+    CHECK(completion->request_stop());
+
+    completion->wait();
+
+    CHECK(completion->stop_requested());
+    CHECK_FALSE(completion->cancelled());
+  }
+
+  TEST_CASE("Absorbing bursts (injection queue)" * doctest::timeout(1)) {
+    simple_scheduler<1> s{1};
+    std::atomic<bool>   started  = false;
+    std::atomic<bool>   released = false;
+    std::atomic<int>    calls    = 0;
+
+    auto blocker = s.schedule([&] {
+      started = true;
+      started.notify_one();
+      released.wait(false);
+    });
+
+    REQUIRE(blocker);
+
+    started.wait(false);
+
+    // Far more tasks than the executor queue can hold.
+    std::vector<completion_token> completions;
+
+    for (int i = 0; i < 100; i++) {
+      auto completion = s.schedule([&] { calls++; });
+      REQUIRE(completion);
+      completions.push_back(*completion);
+
+      auto cancellable = s.schedule([&](std::stop_token) { calls++; });
+      REQUIRE(cancellable);
+      completions.push_back(*cancellable);
+    }
+
+    released = true;
+    released.notify_one();
+
+    for (const auto& completion : completions) {
+      completion.wait();
+    }
+
+    CHECK(calls == 200);
+  }
+
+  TEST_CASE("Spawning nested tasks with a memory resource" * doctest::timeout(1)) {
+    helpers::counting_resource resource;
+
+    {
+      simple_scheduler<10> s{std::allocator_arg, &resource, 1};
+      std::size_t          spawn_allocations = 0;
+
+      auto completion = s.schedule([&] {
+        const auto before = resource.allocations();
+        auto       nested = this_executor::spawn([] {});
+        spawn_allocations = resource.allocations() - before;
+
+        REQUIRE(nested);
+        nested->wait();
+      });
+
+      REQUIRE(completion);
+      completion->wait();
+
+      // The completion data of the spawned task is allocated from the resource of the scheduler.
+      CHECK(spawn_allocations > 0);
+    }
+
+    CHECK(resource.allocations() == resource.deallocations());
+  }
+
+  TEST_CASE("Spilling full executor queues (injection queue)" * doctest::timeout(1)) {
+    simple_scheduler<4> s{1};
+    std::atomic<int>    calls = 0;
+
+    auto parent = s.schedule([&] {
+      std::vector<completion_token> completions;
+
+      // Far more tasks than the executor queue can hold.
+      for (int i = 0; i < 100; i++) {
+        completions.push_back(*this_executor::spawn([&] { calls++; }));
+        completions.push_back(*s.schedule([&] { calls++; }));
+      }
+
+      for (const auto& completion : completions) {
+        completion.wait();
+      }
+    });
+
+    REQUIRE(parent);
+    parent->wait();
+
+    CHECK(calls == 200);
+    CHECK_FALSE(parent->exception());
+  }
+
+  TEST_CASE("Running follow-up tasks next (LIFO slot)" * doctest::timeout(1)) {
+    for (const bool lifo_slot : {true, false}) {
+      simple_scheduler<16>      s{1};
+      std::atomic<bool>         released = false;
+      std::atomic<int>          finished = 0;
+      std::vector<unsigned int> order;
+
+      if (lifo_slot) {
+        s.enable_lifo_slot();
+      } else {
+        s.disable_lifo_slot();
+      }
+
+      auto blocker = s.schedule([&] { released.wait(false); });
+      REQUIRE(blocker);
+
+      auto parent = s.schedule([&] {
+        order.push_back(0);
+        finished++;
+
+        (void)s.schedule([&] {
+          order.push_back(1);
+          finished++;
+        });
+      });
+
+      auto other = s.schedule([&] {
+        order.push_back(2);
+        finished++;
+      });
+
+      REQUIRE(parent);
+      REQUIRE(other);
+
+      released = true;
+      released.notify_one();
+
+      while (finished < 3) {
+        std::this_thread::yield();
+      }
+
+      if (lifo_slot) {
+        CHECK(order == std::vector<unsigned int>{0, 1, 2});
+      } else {
+        CHECK(order == std::vector<unsigned int>{0, 2, 1});
+      }
+    }
+  }
+
+  TEST_CASE("Stealing follow-up tasks of a blocked executor (LIFO slot)" * doctest::skip(NUM_CORES < 2) *
+            doctest::timeout(1)) {
+    simple_scheduler<16> s{2};
+
+    // The follow-up task is put in the LIFO slot, while its parent blocks outside of the scheduler waiting for it.
+    auto completion = s.schedule([&] {
+      std::promise<void> promise;
+      auto               future = promise.get_future();
+
+      (void)s.schedule([&] { promise.set_value(); });
+
+      future.wait();
+    });
+
+    REQUIRE(completion);
+    completion->wait();
+
+    CHECK_FALSE(completion->exception());
+  }
+
+  TEST_CASE("Limiting consecutive LIFO slot use (starvation guard)" * doctest::timeout(1)) {
+    simple_scheduler<16>      s{1};
+    std::atomic<bool>         released = false;
+    std::atomic<bool>         done     = false;
+    std::vector<unsigned int> order;
+
+    auto blocker = s.schedule([&] { released.wait(false); });
+    REQUIRE(blocker);
+
+    std::function<void(unsigned int)> chain = [&](unsigned int step) {
+      order.push_back(step);
+
+      if (step < 10) {
+        (void)s.schedule([&, step] { chain(step + 1); });
+      } else {
+        done = true;
+      }
+    };
+
+    auto first = s.schedule([&] { chain(0); });
+    auto other = s.schedule([&] { order.push_back(100); });
+
+    REQUIRE(first);
+    REQUIRE(other);
+
+    released = true;
+    released.notify_one();
+
+    while (!done) {
+      std::this_thread::yield();
+    }
+
+    other->wait();
+
+    // The queued task runs after the first task and at most three follow-ups.
+    CHECK(std::find(order.begin(), order.end(), 100u) - order.begin() == 4);
+  }
+
+  TEST_CASE("Scheduling tasks with a deadline (earliest deadline first)" * doctest::timeout(1)) {
+    simple_scheduler<16>      s{1};
+    std::atomic<bool>         released = false;
+    std::vector<unsigned int> order;
+
+    auto blocker = s.schedule([&] { released.wait(false); });
+    REQUIRE(blocker);
+
+    const auto now = std::chrono::steady_clock::now();
+
+    auto fifo = s.schedule([&] { order.push_back(0); });
+    auto t3   = s.schedule([&] { order.push_back(3); }, now + 3s);
+    auto t1   = s.schedule([&] { order.push_back(1); }, now + 1s);
+    auto t2   = s.schedule([&] { order.push_back(2); }, now + 2s);
+
+    REQUIRE(fifo);
+    REQUIRE(t1);
+    REQUIRE(t2);
+    REQUIRE(t3);
+
+    released = true;
+    released.notify_one();
+
+    fifo->wait();
+
+    // Tasks with a deadline take precedence over tasks without one.
+    CHECK(order == std::vector<unsigned int>{1, 2, 3, 0});
+  }
+
+  TEST_CASE("Dropping tasks past their deadline" * doctest::timeout(1)) {
+    simple_scheduler<16> s{1};
+    std::atomic<bool>    started  = false;
+    std::atomic<bool>    released = false;
+    std::atomic<int>     calls    = 0;
+
+    auto blocker = s.schedule([&] {
+      started = true;
+      started.notify_one();
+      released.wait(false);
+    });
+
+    REQUIRE(blocker);
+
+    started.wait(false);
+
+    const auto deadline = std::chrono::steady_clock::now() + 10ms;
+
+    auto dropped = s.schedule([&] { calls++; }, deadline, expiry_policy::drop);
+    auto late    = s.schedule([&] { calls++; }, deadline, expiry_policy::run);
+
+    REQUIRE(dropped);
+    REQUIRE(late);
+
+    std::this_thread::sleep_for(20ms);
+
+    released = true;
+    released.notify_one();
+
+    dropped->wait();
+    late->wait();
+
+    CHECK(dropped->cancelled());
+    CHECK_FALSE(late->cancelled());
+    CHECK(calls == 1);
+  }
+
+  TEST_CASE("Scheduling tasks with a deadline (failure cases)" * doctest::timeout(1)) {
+    simple_scheduler<1> s{1};
+    std::atomic<bool>   started  = false;
+    std::atomic<bool>   released = false;
+
+    auto blocker = s.schedule([&] {
+      started = true;
+      started.notify_one();
+      released.wait(false);
+    });
+
+    REQUIRE(blocker);
+
+    started.wait(false);
+
+    const auto deadline = std::chrono::steady_clock::now() + 1s;
+
+    task<void()> t0{[] {}};
+    task<void()> t1{[] {}};
+
+    CHECK(s.schedule(std::move(t0), deadline));
+
+    // The deadline queue is full: the task is handed back.
+    CHECK_FALSE(s.schedule(std::move(t1), deadline));
+    CHECK(t1);
+
+    released = true;
+    released.notify_one();
+  }
+
+  TEST_CASE("Scheduling detached tasks" * doctest::timeout(1)) {
+    simple_scheduler<16> s{1};
+    std::atomic<int>     calls = 0;
+
+    s.wait_idle(); // Idle from the start.
+
+    for (int i = 0; i < 100; i++) {
+      s.schedule_detached([&] { calls++; });
+    }
+
+    s.wait_idle();
+
+    CHECK(calls == 100);
+  }
+
+  TEST_CASE("Handling exceptions of detached tasks" * doctest::timeout(1)) {
+    simple_scheduler<16> s{1};
+    std::atomic<int>     errors = 0;
+
+    s.schedule_detached([] { throw std::runtime_error{"discarded"}; });
+    s.wait_idle();
+
+    s.set_exception_handler([&](std::exception_ptr error) {
+      try {
+        std::rethrow_exception(error);
+      } catch (const std::runtime_error&) {
+        errors++;
+      }
+    });
+
+    for (int i = 0; i < 3; i++) {
+      s.schedule_detached([] { throw std::runtime_error{"test"}; });
+    }
+
+    s.schedule_detached([] {});
+    s.wait_idle();
+
+    CHECK(errors == 3);
+  }
+
+  TEST_CASE("Waiting for idle after flushing" * doctest::timeout(1)) {
+    simple_scheduler<16> s{1};
+    std::atomic<bool>    started  = false;
+    std::atomic<bool>    released = false;
+    std::atomic<int>     calls    = 0;
+
+    s.schedule_detached([&] {
+      started = true;
+      started.notify_one();
+      released.wait(false);
+    });
+
+    started.wait(false);
+
+    for (int i = 0; i < 10; i++) {
+      s.schedule_detached([&] { calls++; });
+    }
+
+    s.flush();
+
+    released = true;
+    released.notify_one();
+
+    s.wait_idle();
+
+    CHECK(calls == 0);
+  }
+
+  TEST_CASE("Waiting for idle (failure cases)" * doctest::timeout(1)) {
+    simple_scheduler<16> s{1};
+
+    auto waiter = s.schedule([&] { s.wait_idle(); });
+
+    REQUIRE(waiter);
+    waiter->wait();
+
+    REQUIRE(waiter->exception());
+    CHECK_THROWS_AS(std::rethrow_exception(*waiter->exception()), std::logic_error);
+  }
+
+  TEST_CASE("Scheduling with executor affinity" * doctest::timeout(1)) {
+    simple_scheduler<16> s{NUM_CORES};
+    std::atomic<int>     calls = 0;
+
+    std::vector<completion_token> completions;
+
+    for (std::size_t i = 0; i < s.num_executors(); i++) {
+      completions.push_back(*s.schedule_on(i, [&] { calls++; }));
+    }
+
+    completions.push_back(*s.schedule_keyed(42, [&] { calls++; }));
+    completions.push_back(*s.schedule_keyed(std::string{"shard"}, [&] { calls++; }));
+    const auto identity = [](int key) { return static_cast<std::size_t>(key); };
+
+    completions.push_back(*s.schedule_keyed(7, [&] { calls++; }, identity));
+
+    for (const auto& completion : completions) {
+      completion.wait();
+    }
+
+    CHECK(calls == static_cast<int>(s.num_executors()) + 3);
+  }
+
+  TEST_CASE("Scheduling with executor affinity from within a task" * doctest::timeout(1)) {
+    simple_scheduler<4> s{1};
+    std::vector<int>    order;
+
+    // Scheduling on the own executor bypasses the LIFO slot, and overflows to the injection queue when full.
+    auto outer = s.schedule([&] {
+      for (int i = 0; i < 10; i++) {
+        (void)s.schedule_on(0, [&, i] { order.push_back(i); });
+      }
+    });
+
+    REQUIRE(outer);
+    outer->wait();
+    s.wait_idle();
+
+    REQUIRE(order.size() == 10);
+    CHECK(std::ranges::is_permutation(order, std::vector{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+  }
+
+  TEST_CASE("Scheduling with executor affinity (failure cases)") {
+    simple_scheduler<16> s{1};
+
+    CHECK_THROWS_AS((void)s.schedule_on(1, [] {}), std::out_of_range);
+  }
+
+  TEST_CASE("Accessing the executor context" * doctest::timeout(1)) {
+    simple_scheduler<16> s{NUM_CORES};
+
+    CHECK_THROWS_AS((void)this_executor::context(), std::logic_error);
+
+    std::atomic<std::size_t> id = NUM_CORES;
+
+    auto from_executor = s.schedule([&] { id = this_executor::context().id(); });
+    REQUIRE(from_executor);
+    from_executor->wait();
+
+    CHECK(id < s.num_executors());
+
+    id = NUM_CORES;
+
+    auto from_argument = s.schedule([&](executor_context& context) {
+      CHECK(&context == &this_executor::context());
+      id = context.id();
+    });
+
+    REQUIRE(from_argument);
+    from_argument->wait();
+
+    CHECK(id < s.num_executors());
+  }
+
+  TEST_CASE("Resetting the executor arena between tasks" * doctest::timeout(1)) {
+    simple_scheduler<16> s{1};
+    void*                first  = nullptr;
+    void*                second = nullptr;
+    void*                nested = nullptr;
+
+    auto outer = s.schedule([&](executor_context& context) {
+      first = context.arena().allocate(64);
+
+      // The arena is not reset by a nested task, run while waiting.
+      auto inner = s.schedule([&] { nested = this_executor::context().arena().allocate(64); });
+
+      REQUIRE(inner);
+      inner->wait();
+    });
+
+    REQUIRE(outer);
+    outer->wait();
+    s.wait_idle();
+
+    auto next = s.schedule([&](executor_context& context) { second = context.arena().allocate(64); });
+
+    REQUIRE(next);
+    next->wait();
+
+    CHECK(first != nullptr);
+    CHECK(nested != first);
+    CHECK(second == first);
+  }
+
+  TEST_CASE("Scheduling in partitions" * doctest::timeout(1)) {
+    simple_scheduler<16> s{NUM_CORES};
+    std::atomic<int>     calls = 0;
+
+    const auto first  = s.create_partition("first");
+    const auto second = s.create_partition("second", {.weight = 4});
+
+    CHECK(s.find_partition("first") == first);
+    CHECK(s.find_partition("second") == second);
+    CHECK_FALSE(s.find_partition("third"));
+
+    std::vector<completion_token> completions;
+
+    for (int i = 0; i < 10; i++) {
+      completions.push_back(*s.schedule_in(first, [&] { calls++; }));
+      completions.push_back(*s.schedule_in(second, [&] { calls++; }));
+      completions.push_back(*s.schedule([&] { calls++; }));
+    }
+
+    for (const auto& completion : completions) {
+      completion.wait();
+    }
+
+    CHECK(calls == 30);
+  }
+
+  TEST_CASE("Scheduling in partitions (failure cases)") {
+    simple_scheduler<16> s{1};
+
+    CHECK_THROWS_AS((void)s.schedule_in(0, [] {}), std::out_of_range);
+    CHECK_THROWS_AS(s.create_partition("zero", {.weight = 0}), std::invalid_argument);
+    CHECK_THROWS_AS(s.create_partition("executor", {.executors = {s.max_executors()}}), std::invalid_argument);
+
+    (void)s.create_partition("name");
+
+    CHECK_THROWS_AS(s.create_partition("name"), std::invalid_argument);
+
+    for (int i = 1; i < 64; i++) {
+      (void)s.create_partition(std::to_string(i));
+    }
+
+    CHECK_THROWS_AS(s.create_partition("overflow"), std::length_error);
+  }
+
+  TEST_CASE("Weighted fair sharing between partitions" * doctest::timeout(1)) {
+    simple_scheduler<16> s{1};
+    std::vector<char>    order;
+
+    const auto light = s.create_partition("light");
+    const auto heavy = s.create_partition("heavy", {.weight = 3});
+
+    // Hold the executor until both partitions are flooded.
+    std::atomic<bool> started  = false;
+    std::atomic<bool> released = false;
+
+    s.schedule_detached([&] {
+      started = true;
+      started.notify_one();
+      released.wait(false);
+    });
+
+    started.wait(false);
+
+    for (int i = 0; i < 20; i++) {
+      (void)s.schedule_in(light, [&] { order.push_back('l'); });
+      (void)s.schedule_in(heavy, [&] { order.push_back('h'); });
+    }
+
+    released = true;
+    released.notify_one();
+    s.wait_idle();
+
+    REQUIRE(order.size() == 40);
+
+    // While both partitions have work, the heavy partition gets three turns for every turn of the light one.
+    CHECK(std::count(order.begin(), order.begin() + 20, 'l') == 5);
+    CHECK(std::count(order.begin(), order.begin() + 20, 'h') == 15);
+  }
+
+  TEST_CASE("Restricting partitions to executors" * doctest::skip(NUM_CORES < 2) * doctest::timeout(1)) {
+    simple_scheduler<16>         s{2};
+    std::vector<std::thread::id> threads(20);
+
+    const auto restricted = s.create_partition("restricted", {.executors = {1}});
+
+    std::vector<completion_token> completions;
+
+    for (std::size_t i = 0; i < threads.size(); i++) {
+      completions.push_back(*s.schedule_in(restricted, [&, i] { threads[i] = std::this_thread::get_id(); }));
+    }
+
+    for (const auto& completion : completions) {
+      completion.wait();
+    }
+
+    CHECK(std::ranges::all_of(threads, [&](const auto& id) { return id == threads.front(); }));
+  }
+
+  TEST_CASE("Scheduling indexed bulk work" * doctest::timeout(2)) {
+    simple_scheduler<16>                s{NUM_CORES};
+    std::vector<std::atomic<int>>       calls(10'000);
+    constexpr std::array<std::size_t, 4> chunk_sizes{0, 1, 7, 20'000};
+
+    for (const auto chunk_size : chunk_sizes) {
+      auto completion = s.schedule_n(calls.size(), [&](std::size_t index) { calls[index]++; }, chunk_size);
+
+      REQUIRE(completion);
+      completion->wait();
+      CHECK_FALSE(completion->cancelled());
+      CHECK_FALSE(completion->exception());
+    }
+
+    CHECK(std::ranges::all_of(calls, [](const auto& c) { return c == 4; }));
+
+    // An empty range completes immediately.
+    auto empty = s.schedule_n(0, [&](std::size_t) { calls[0]++; });
+
+    REQUIRE(empty);
+    CHECK(*empty);
+    CHECK(calls[0] == 4);
+  }
+
+  TEST_CASE("Scheduling indexed bulk work from within a task" * doctest::timeout(2)) {
+    simple_scheduler<16>     s{NUM_CORES};
+    std::atomic<std::size_t> sum = 0;
+
+    auto outer = s.schedule([&] {
+      auto inner = s.schedule_n(100, [&](std::size_t index) { sum += index; }, 3);
+
+      REQUIRE(inner);
+      inner->wait();
+    });
+
+    REQUIRE(outer);
+    outer->wait();
+
+    CHECK(sum == 4'950);
+  }
+
+  TEST_CASE("Scheduling indexed bulk work (failure cases)" * doctest::timeout(1)) {
+    simple_scheduler<16> s{1};
+    std::atomic<int>     calls = 0;
+
+    // A throwing call skips the remaining indices, and the exception is reported.
+    auto failed = s.schedule_n(100, [&](std::size_t index) {
+      calls++;
+
+      if (index == 10) {
+        throw std::runtime_error{"test"};
+      }
+    }, 1);
+
+    REQUIRE(failed);
+    failed->wait();
+
+    CHECK(calls == 11);
+    CHECK_FALSE(failed->cancelled());
+    REQUIRE(failed->exception());
+    CHECK_THROWS_AS(std::rethrow_exception(*failed->exception()), std::runtime_error);
+
+    // Cancellation before the executor gets to the work skips all indices.
+    std::atomic<bool> started  = false;
+    std::atomic<bool> released = false;
+
+    s.schedule_detached([&] {
+      started = true;
+      started.notify_one();
+      released.wait(false);
+    });
+
+    started.wait(false);
+
+    calls          = 0;
+    auto cancelled = s.schedule_n(100, [&](std::size_t) { calls++; });
+
+    REQUIRE(cancelled);
+    CHECK(cancelled->request_stop());
+
+    released = true;
+    released.notify_one();
+
+    cancelled->wait();
+
+    CHECK(calls == 0);
+    CHECK(cancelled->cancelled());
+  }
+
+  TEST_CASE("Blocking region outside an executor") {
+    CHECK_NOTHROW(blocking_region{});
+    CHECK(mark_blocking([] { return 42; }) == 42);
+  }
+
+  TEST_CASE("Compensating blocked executors (managed blocking)" * doctest::timeout(1)) {
+    simple_scheduler<16> s{1};
+    std::atomic<bool>    released = false;
+
+    // With a single executor, this would deadlock if the blocked executor was not compensated for.
+    auto blocked = s.schedule([&] { mark_blocking([&] { released.wait(false); }); });
+    auto release = s.schedule([&] {
+      released = true;
+      released.notify_one();
+    });
+
+    REQUIRE(blocked);
+    REQUIRE(release);
+
+    blocked->wait();
+    release->wait();
+
+    CHECK(released);
+    CHECK_FALSE(blocked->exception().has_value());
+  }
+
+  TEST_CASE("Nested blocking regions" * doctest::timeout(1)) {
+    simple_scheduler<16>      s{1};
+    std::atomic<unsigned int> released = 0;
+
+    const auto block = [&](unsigned int count) {
+      mark_blocking([&] {
+        released++;
+        released.notify_all();
+
+        while (released.load() < count) {
+          released.wait(released.load());
+        }
+      });
+    };
+
+    auto outer = s.schedule([&] {
+      blocking_region region;
+      block(3);
+    });
+    auto inner = s.schedule([&] { block(3); });
+    auto last  = s.schedule([&] { block(3); });
+
+    REQUIRE(outer);
+    REQUIRE(inner);
+    REQUIRE(last);
+
+    outer->wait();
+    inner->wait();
+    last->wait();
+
+    CHECK(released == 3);
+  }
+
+  TEST_CASE("Destruction while compensators enter blocking regions" * doctest::timeout(2)) {
+    std::atomic<unsigned int> started  = 0;
+    std::atomic<unsigned int> finished = 0;
+
+    {
+      simple_scheduler<16> s{1};
+
+      // The executor blocks, so compensators run the queued tasks, which block in turn while the scheduler is being
+      //  destroyed.
+      for (unsigned int i = 0; i < 8; i++) {
+        (void)s.schedule([&] {
+          started++;
+          mark_blocking([] { std::this_thread::sleep_for(2ms); });
+          finished++;
+        });
+      }
+
+      std::this_thread::sleep_for(1ms);
+    }
+
+    CHECK(started > 0);
+    CHECK(started == finished);
+  }
+
+  TEST_CASE("Resizing the executor pool (failure cases)" * doctest::timeout(1)) {
+    simple_scheduler<10> s{1};
+
+    CHECK_THROWS_AS(s.resize(0), std::underflow_error);
+    CHECK_THROWS_AS(s.resize(s.max_executors() + 1), std::overflow_error);
+    CHECK_NOTHROW(s.resize(1));
+    CHECK(s.num_executors() == 1);
+
+    auto completion = s.schedule([&] { s.resize(1); });
+
+    REQUIRE(completion);
+
+    completion->wait();
+
+    REQUIRE(completion->exception().has_value());
+    CHECK_THROWS_AS(std::rethrow_exception(*completion->exception()), std::logic_error);
+  }
+
+  TEST_CASE("Resizing the executor pool" * doctest::skip(NUM_CORES < 2) * doctest::timeout(2)) {
+    simple_scheduler<16>      s{1};
+    std::atomic<unsigned int> count = 0;
+
+    s.resize(2);
+
+    CHECK(s.num_executors() == 2);
+
+    std::vector<completion_token> completions;
+    for (unsigned int i = 0; i < 16; i++) {
+      auto completion = s.schedule([&] {
+        std::this_thread::sleep_for(1ms);
+        count++;
+      });
+
+      REQUIRE(completion);
+      completions.push_back(*completion);
+    }
+
+    // Work queued for the retired executor is taken over by the remaining executor.
+    s.resize(1);
+
+    CHECK(s.num_executors() == 1);
+
+    for (auto& completion : completions) {
+      completion.wait();
+    }
+
+    CHECK(count == 16);
+  }
+
+  TEST_CASE("Scheduling with executor affinity while resizing" * doctest::skip(NUM_CORES < 2) * doctest::timeout(5)) {
+    simple_scheduler<16>      s{1};
+    std::atomic<unsigned int> count = 0;
+    std::atomic<bool>         done  = false;
+
+    std::jthread resizer{[&] {
+      while (!done) {
+        s.resize(2);
+        s.resize(1);
+      }
+    }};
+
+    std::vector<completion_token> completions;
+    for (unsigned int i = 0; i < 1'000; i++) {
+      auto completion = s.schedule_keyed(i, [&] { count++; });
+
+      REQUIRE(completion);
+      completions.push_back(*completion);
+    }
+
+    done = true;
+    resizer.join();
+
+    for (auto& completion : completions) {
+      completion.wait();
+    }
+
+    CHECK(count == 1'000);
+  }
+
+  TEST_CASE("Auto-scaling the executor pool" * doctest::skip(NUM_CORES < 2) * doctest::timeout(5)) {
+    simple_scheduler<64> s{1};
+
+    s.enable_auto_scaling({.min_executors        = 1,
+                           .max_executors        = 2,
+                           .backlog_per_executor = 1,
+                           .interval             = 1ms,
+                           .cool_down            = 20ms});
+
+    const auto wait_for_executors = [&](std::size_t num_executors) {
+      while (s.num_executors() != num_executors) {
+        std::this_thread::sleep_for(1ms);
+      }
+    };
+
+    std::vector<completion_token> completions;
+    for (unsigned int i = 0; i < 32; i++) {
+      auto completion = s.schedule([] { std::this_thread::sleep_for(5ms); });
+
+      REQUIRE(completion);
+      completions.push_back(*completion);
+    }
+
+    // The backlog grows the pool, and the pool shrinks again after the cool-down.
+    wait_for_executors(2);
+
+    for (auto& completion : completions) {
+      completion.wait();
+    }
+
+    wait_for_executors(1);
+
+    s.disable_auto_scaling();
+
+    CHECK(s.num_executors() == 1);
+  }
+
+  TEST_CASE("Auto-scaling the executor pool (failure cases)") {
+    simple_scheduler<10> s{1};
+
+    CHECK_THROWS_AS(s.enable_auto_scaling({.min_executors = 0}), std::underflow_error);
+    CHECK_THROWS_AS(s.enable_auto_scaling({.max_executors = s.max_executors() + 1}), std::overflow_error);
+    CHECK_THROWS_AS(s.enable_auto_scaling({.min_executors = 2, .max_executors = 1}), std::invalid_argument);
+  }
+
 } // TEST_SUITE
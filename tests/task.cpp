@@ -3,6 +3,7 @@
 
 #include <doctest/doctest.h>
 
+#include <memory>
 #include <utility>
 
 #include "helpers.hpp"
@@ -149,6 +150,31 @@ TEST_SUITE("task") {
     CHECK_THROWS(std::apply(t1, make_args<T>()));
   }
 
+  TEST_CASE("Construction with a memory resource") {
+    helpers::counting_resource resource;
+
+    {
+      bool         is_called = false;
+      task<void()> t{std::allocator_arg, &resource, [&] { is_called = true; }};
+
+      CHECK(resource.allocations() == 1);
+
+      task<void()> u{std::move(t)};
+      u();
+
+      CHECK(is_called);
+      CHECK(resource.allocations() == 1);
+      CHECK(resource.deallocations() == 0);
+    }
+
+    CHECK(resource.deallocations() == 1);
+
+    // Without a memory resource, the heap is used.
+    task<int()> t{std::allocator_arg, nullptr, [] { return 42; }};
+
+    CHECK(t() == 42);
+  }
+
   TEST_CASE("task argument propagation (matched signatures)") {
     SUBCASE("value") {
       task<void(value)> t{[](value arg) { CHECK(arg.value == 42); }};
@@ -0,0 +1,92 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "../source/topology.hpp"
+
+#include <doctest/doctest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+using namespace ts;
+
+namespace {
+
+class fake_sysfs final {
+  std::filesystem::path root_;
+
+public:
+  fake_sysfs()
+    : root_{std::filesystem::temp_directory_path() / "ts_fake_sysfs"} {
+    std::filesystem::remove_all(root_);
+    std::filesystem::create_directories(root_);
+  }
+
+  ~fake_sysfs() {
+    std::filesystem::remove_all(root_);
+  }
+
+  fake_sysfs(const fake_sysfs&)            = delete;
+  fake_sysfs& operator=(const fake_sysfs&) = delete;
+
+  void add_node(const std::string& name, const std::string& cpulist) {
+    std::filesystem::create_directories(root_ / name);
+    std::ofstream{root_ / name / "cpulist"} << cpulist << '\n';
+  }
+
+  [[nodiscard]] const std::filesystem::path& root() const {
+    return root_;
+  }
+};
+
+} // namespace
+
+TEST_SUITE("topology") {
+  TEST_CASE("Parsing CPU lists") {
+    CHECK(parse_cpu_list("") == cpu_list{});
+    CHECK(parse_cpu_list("0") == cpu_list{0});
+    CHECK(parse_cpu_list("0-3") == cpu_list{0, 1, 2, 3});
+    CHECK(parse_cpu_list("0-1,4,6-7") == cpu_list{0, 1, 4, 6, 7});
+    CHECK(parse_cpu_list("2,0\n") == cpu_list{2, 0});
+  }
+
+  TEST_CASE("Parsing CPU lists (failure cases)") {
+    CHECK_THROWS_AS((void)parse_cpu_list("x"), std::invalid_argument);
+    CHECK_THROWS_AS((void)parse_cpu_list("1-"), std::invalid_argument);
+    CHECK_THROWS_AS((void)parse_cpu_list("3-1"), std::invalid_argument);
+    CHECK_THROWS_AS((void)parse_cpu_list("1,,2"), std::invalid_argument);
+  }
+
+  TEST_CASE("Reading the NUMA topology") {
+    fake_sysfs sysfs;
+    sysfs.add_node("node1", "4-7");
+    sysfs.add_node("node0", "0-3");
+    sysfs.add_node("node2", "");
+    sysfs.add_node("possible", "0-1");
+
+    const auto nodes = read_numa_topology(sysfs.root());
+
+    REQUIRE(nodes.size() == 2);
+    CHECK(nodes[0].id == 0);
+    CHECK(nodes[0].cpus == cpu_list{0, 1, 2, 3});
+    CHECK(nodes[1].id == 1);
+    CHECK(nodes[1].cpus == cpu_list{4, 5, 6, 7});
+  }
+
+  TEST_CASE("Reading the NUMA topology (fallback)") {
+    const auto nodes = read_numa_topology("/nonexistent");
+
+    REQUIRE(nodes.size() == 1);
+    CHECK(nodes[0].id == 0);
+    CHECK(nodes[0].cpus.size() == std::max(std::thread::hardware_concurrency(), 1u));
+  }
+
+  TEST_CASE("NUMA placement") {
+    const auto placement = numa_placement({{0, {0, 1}}, {1, {2, 3, 4}}});
+
+    CHECK(placement.cpus == cpu_list{0, 1, 2, 3, 4});
+    CHECK(placement.nodes == std::vector<unsigned int>{0, 0, 1, 1, 1});
+  }
+
+} // TEST_SUITE
@@ -0,0 +1,147 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "../source/tracing.hpp"
+
+#include <doctest/doctest.h>
+
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "../source/simple_scheduler.hpp"
+
+using namespace ts;
+
+static_assert(tracing_enabled, "Tracing tests must be compiled with TS_ENABLE_TRACING");
+
+namespace {
+
+std::size_t count_occurrences(const std::string& text, const std::string& pattern) {
+  std::size_t count = 0;
+
+  for (auto pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + pattern.size())) {
+    count++;
+  }
+
+  return count;
+}
+
+std::string chrome_trace() {
+  std::ostringstream stream;
+  tracing::write_chrome_trace(stream);
+  return stream.str();
+}
+
+} // namespace
+
+TEST_SUITE("tracing") {
+  TEST_CASE("Inactive by default") {
+    CHECK_FALSE(tracing::is_active());
+    CHECK(detail::trace_job_id() == 0);
+  }
+
+  TEST_CASE("Starting and stopping") {
+    tracing::start();
+    CHECK(tracing::is_active());
+    CHECK(detail::trace_job_id() != 0);
+
+    tracing::stop();
+    CHECK_FALSE(tracing::is_active());
+  }
+
+  TEST_CASE("Ring buffer overwrites the oldest events") {
+    detail::trace_buffer buffer{0};
+
+    for (std::size_t i = 0; i < detail::trace_buffer::CAPACITY + 10; i++) {
+      buffer.record(detail::trace_event_type::scheduled, i + 1);
+    }
+
+    std::size_t count    = 0;
+    std::size_t first_id = 0;
+
+    buffer.for_each([&](const detail::trace_event& event) {
+      if (count++ == 0) {
+        first_id = event.job_id;
+      }
+    });
+
+    CHECK(count == detail::trace_buffer::CAPACITY);
+    CHECK(first_id == 11);
+
+    buffer.clear();
+
+    count = 0;
+    buffer.for_each([&](const detail::trace_event&) { count++; });
+    CHECK(count == 0);
+  }
+
+  TEST_CASE("Tracing scheduled jobs" * doctest::timeout(1)) {
+    tracing::clear();
+
+    {
+      simple_scheduler<10> s{1};
+
+      // Jobs scheduled while tracing is inactive are not traced.
+      auto untraced = s.schedule([] {});
+      REQUIRE(untraced);
+      untraced->wait();
+
+      tracing::start();
+
+      for (unsigned int i = 0; i < 3; i++) {
+        auto completion = s.schedule([] {});
+        REQUIRE(completion);
+        completion->wait();
+      }
+
+      tracing::stop();
+    }
+
+    const auto trace = chrome_trace();
+
+    CHECK(trace.starts_with("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["));
+    CHECK(count_occurrences(trace, "\"name\":\"schedule\"") == 3);
+    CHECK(count_occurrences(trace, "\"name\":\"dequeue (local)\"") == 3);
+    CHECK(count_occurrences(trace, "\"ph\":\"B\"") == 3);
+    CHECK(count_occurrences(trace, "\"ph\":\"E\"") == 3);
+    CHECK(count_occurrences(trace, "\"ph\":\"s\"") == 3);
+    CHECK(count_occurrences(trace, "\"ph\":\"f\"") == 3);
+    CHECK(trace.find("\"name\":\"executor 0\"") != std::string::npos);
+
+    tracing::clear();
+
+    CHECK(count_occurrences(chrome_trace(), "\"cat\":\"job\"") == 0);
+  }
+
+  TEST_CASE("Naming a thread does not create a trace buffer") {
+    std::thread{[] { detail::trace_thread_name("idle thread"); }}.join();
+
+    CHECK(chrome_trace().find("\"name\":\"idle thread\"") == std::string::npos);
+  }
+
+  TEST_CASE("Buffers of exited threads are kept until cleared") {
+    tracing::clear();
+    tracing::start();
+
+    std::thread{[] {
+      detail::trace_thread_name("traced thread");
+      detail::trace(detail::trace_event_type::scheduled, detail::trace_job_id());
+    }}.join();
+
+    tracing::stop();
+
+    CHECK(chrome_trace().find("\"name\":\"traced thread\"") != std::string::npos);
+
+    tracing::clear();
+
+    CHECK(chrome_trace().find("\"name\":\"traced thread\"") == std::string::npos);
+  }
+
+  TEST_CASE("Thread names are escaped") {
+    std::ostringstream stream;
+    detail::write_json_escaped(stream, "a \"b\" \\c\n\x01");
+
+    CHECK(stream.str() == "a \\\"b\\\" \\\\c\\n\\u0001");
+  }
+
+} // TEST_SUITE